@@ -11,7 +11,7 @@ set_property(TARGET SimRobotCore2D PROPERTY PDB_OUTPUT_DIRECTORY "${SIMROBOT_LIB
 set_property(TARGET SimRobotCore2D PROPERTY AUTOMOC ON)
 set_property(TARGET SimRobotCore2D PROPERTY AUTORCC ON)
 target_include_directories(SimRobotCore2D PRIVATE "${SIMROBOTCORE2D_ROOT_DIR}")
-target_link_libraries(SimRobotCore2D PRIVATE Qt6::Core Qt6::Gui Qt6::Svg Qt6::Widgets)
+target_link_libraries(SimRobotCore2D PRIVATE Qt6::Concurrent Qt6::Core Qt6::Gui Qt6::Svg Qt6::Widgets)
 target_link_libraries(SimRobotCore2D PRIVATE Eigen::Eigen)
 target_link_libraries(SimRobotCore2D PRIVATE box2d::box2d)
 target_link_libraries(SimRobotCore2D PRIVATE SimRobotInterface)
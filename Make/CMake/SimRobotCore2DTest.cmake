@@ -0,0 +1,21 @@
+set(SIMROBOTCORE2DTEST_ROOT_DIR "${SIMROBOT_PREFIX}/Src/SimRobotCore2DTest")
+
+file(GLOB_RECURSE SIMROBOTCORE2DTEST_SOURCES CONFIGURE_DEPENDS
+    "${SIMROBOTCORE2DTEST_ROOT_DIR}/*.cpp" "${SIMROBOTCORE2DTEST_ROOT_DIR}/*.h")
+
+# The core is a module, so the test builds its sources into a headless executable.
+add_executable(SimRobotCore2DTest ${SIMROBOTCORE2DTEST_SOURCES} ${SIMROBOTCORE2D_SOURCES})
+set_property(TARGET SimRobotCore2DTest PROPERTY FOLDER Tests)
+set_property(TARGET SimRobotCore2DTest PROPERTY AUTOMOC ON)
+set_property(TARGET SimRobotCore2DTest PROPERTY AUTORCC ON)
+target_include_directories(SimRobotCore2DTest PRIVATE "${SIMROBOTCORE2D_ROOT_DIR}")
+target_link_libraries(SimRobotCore2DTest PRIVATE Qt6::Concurrent Qt6::Core Qt6::Gui Qt6::Svg Qt6::Widgets)
+target_link_libraries(SimRobotCore2DTest PRIVATE Eigen::Eigen)
+target_link_libraries(SimRobotCore2DTest PRIVATE box2d::box2d)
+target_link_libraries(SimRobotCore2DTest PRIVATE SimRobotInterface)
+target_link_libraries(SimRobotCore2DTest PRIVATE SimRobotCommon)
+target_link_libraries(SimRobotCore2DTest PRIVATE Flags::DebugInDevelop)
+
+source_group(TREE "${SIMROBOTCORE2DTEST_ROOT_DIR}" FILES ${SIMROBOTCORE2DTEST_SOURCES})
+
+add_test(NAME SimRobotCore2DTest COMMAND SimRobotCore2DTest)
@@ -11,7 +11,7 @@ set_property(TARGET SimRobotCore3 PROPERTY PDB_OUTPUT_DIRECTORY "${SIMROBOT_LIBR
 set_property(TARGET SimRobotCore3 PROPERTY AUTOMOC ON)
 set_property(TARGET SimRobotCore3 PROPERTY AUTORCC ON)
 target_include_directories(SimRobotCore3 PRIVATE "${SIMROBOTCORE3_ROOT_DIR}")
-target_link_libraries(SimRobotCore3 PRIVATE Qt6::Core Qt6::Gui Qt6::OpenGL Qt6::OpenGLWidgets Qt6::Widgets)
+target_link_libraries(SimRobotCore3 PRIVATE Qt6::Concurrent Qt6::Core Qt6::Gui Qt6::OpenGL Qt6::OpenGLWidgets Qt6::Widgets)
 target_link_libraries(SimRobotCore3 PRIVATE Eigen::Eigen)
 target_link_libraries(SimRobotCore3 PRIVATE mujoco::mujoco)
 target_link_libraries(SimRobotCore3 PRIVATE SimRobotInterface)
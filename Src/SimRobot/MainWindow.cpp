@@ -24,11 +24,13 @@
 #include <QCloseEvent>
 #include <QUrl>
 #include <QTimer>
+#include <QLabel>
 #include <QWidget>
 #ifdef WINDOWS
 #include <Windows.h>
 #elif defined MACOS
 #include <mach/mach_time.h>
+#include <ctime>
 #include "AppleHelper.h"
 #ifdef FIX_MACOS_TOOLBAR_WIDGET_NOT_CLOSING
 #include <QWidgetAction>
@@ -36,6 +38,7 @@
 #else
 #include <ctime>
 #endif
+#include <algorithm>
 #include <iostream>
 
 #ifdef MACOS
@@ -261,6 +264,21 @@ unsigned int MainWindow::getSystemTime()
 #endif
 }
 
+qint64 MainWindow::getThreadCpuTime()
+{
+#ifdef WINDOWS
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  if(!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+    return 0;
+  const auto toNsecs = [](const FILETIME& time) {return ((static_cast<qint64>(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 100;};
+  return toNsecs(kernelTime) + toNsecs(userTime);
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<qint64>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+}
+
 bool MainWindow::registerObject(const SimRobot::Module& module, SimRobot::Object& object, const SimRobot::Object* parent, int flags)
 {
   if(sceneGraphDockWidget)
@@ -396,8 +414,19 @@ void MainWindow::closeEvent(QCloseEvent* event)
 
 void MainWindow::timerEvent(QTimerEvent* event)
 {
-  for(LoadedModule* loadedModule : loadedModules)
-    loadedModule->module->update();
+  // When running as fast as possible, several steps are done per event to save the overhead of the event loop.
+  // Control is returned to it when the GUI has to be updated or after a while to keep it responsive.
+  QElapsedTimer timer;
+  timer.start();
+  const qint64 startCpuTime = getThreadCpuTime();
+  do
+  {
+    for(LoadedModule* loadedModule : loadedModules)
+      loadedModule->module->update();
+  }
+  while(running && !updatePeriod && guiUpdateRate > 0 && timer.elapsed() < maxBatchDuration
+        && getSystemTime() - lastGuiUpdate <= static_cast<unsigned int>(guiUpdateRate));
+  simulationCpuTime += getThreadCpuTime() - startCpuTime;
 
   // update gui
   const unsigned int now = getSystemTime();
@@ -410,6 +439,8 @@ void MainWindow::timerEvent(QTimerEvent* event)
     if(statusBar->isVisible())
       statusBar->update();
   }
+  updateLoad();
+
   if(!running)
   {
     Q_ASSERT(event->timerId() == timerId);
@@ -418,6 +449,45 @@ void MainWindow::timerEvent(QTimerEvent* event)
   }
 }
 
+void MainWindow::startUpdateTimer()
+{
+  if(timerId)
+    killTimer(timerId);
+
+  // Modules that run in real time only need to be updated once per step. The time between the updates is
+  // slept (with a precise timer), so a simulation that waits for the real time does not occupy a core.
+  updatePeriod = 0;
+  for(LoadedModule* loadedModule : loadedModules)
+    if(const unsigned int period = loadedModule->module->getUpdatePeriod(); period && (!updatePeriod || period < updatePeriod))
+      updatePeriod = period;
+  if(updatePeriod)
+    timerId = startTimer(std::max(1u, updatePeriod / 1000), Qt::PreciseTimer);
+  else
+    timerId = startTimer(0);
+
+  loadTimer.start();
+  loadStartCpuTime = getThreadCpuTime();
+  simulationCpuTime = 0;
+}
+
+void MainWindow::updateLoad()
+{
+  const qint64 elapsed = loadTimer.nsecsElapsed();
+  if(!running)
+    simulationLoad = guiLoad = 0;
+  else if(elapsed >= 1000000000)
+  {
+    // The views are painted by the event loop after they were told to update, so everything else the thread
+    // spent CPU time on is counted as GUI.
+    const qint64 cpuTime = getThreadCpuTime();
+    simulationLoad = static_cast<int>(simulationCpuTime * 100 / elapsed);
+    guiLoad = static_cast<int>(std::max<qint64>(0, cpuTime - loadStartCpuTime - simulationCpuTime) * 100 / elapsed);
+    loadTimer.start();
+    loadStartCpuTime = cpuTime;
+    simulationCpuTime = 0;
+  }
+}
+
 void MainWindow::dragEnterEvent(QDragEnterEvent* event)
 {
   if(event->mimeData()->hasUrls())
@@ -617,6 +687,33 @@ bool MainWindow::compileModules()
   // link modules
   for(LoadedModule* loadedModule : loadedModules)
     loadedModule->module->link();
+
+  // show how the time is shared between the simulation and the gui
+  class LoadLabel : public QLabel, public SimRobot::StatusLabel
+  {
+  public:
+    LoadLabel(const MainWindow& mainWindow) : mainWindow(mainWindow)
+    {
+      setToolTip(tr("Share of the CPU time spent in simulating (including controllers) and in updating the views"));
+    }
+
+  private:
+    const MainWindow& mainWindow;
+    int lastSimulationLoad = -1;
+    int lastGuiLoad = -1;
+
+    QWidget* getWidget() override {return this;}
+    void update() override
+    {
+      if(mainWindow.simulationLoad != lastSimulationLoad || mainWindow.guiLoad != lastGuiLoad)
+      {
+        lastSimulationLoad = mainWindow.simulationLoad;
+        lastGuiLoad = mainWindow.guiLoad;
+        setText(tr("sim %1%, gui %2%").arg(lastSimulationLoad).arg(lastGuiLoad));
+      }
+    }
+  };
+  statusBar->addLabel(nullptr, new LoadLabel(*this));
   return true;
 }
 
@@ -1156,8 +1253,7 @@ void MainWindow::simStart()
       return;
     running = true;
     simStartAct->setChecked(true);
-    if(!timerId)
-      timerId = startTimer(0);
+    startUpdateTimer();
   }
 }
 
@@ -8,6 +8,7 @@
 
 #include <QMainWindow>
 #include <QActionGroup>
+#include <QElapsedTimer>
 #include <QSettings>
 #include <QSet>
 #include <QHash>
@@ -36,6 +37,12 @@ private:
   static unsigned int getAppLocationSum(const QString& appPath);
   static unsigned int getSystemTime();
 
+  /**
+   * Returns the CPU time the calling thread has consumed so far.
+   * @return The CPU time in nanoseconds.
+   */
+  static qint64 getThreadCpuTime();
+
   class LoadedModule : public QLibrary
   {
   public:
@@ -47,7 +54,14 @@ private:
     LoadedModule(const QString& name) : QLibrary(name) {}
   };
 
-  int timerId = 0; /**< The id of the timer used to get something like an OnIdle callback function to update the simulation. */
+  int timerId = 0; /**< The id of the timer that triggers updates of the simulation (none while paused). */
+  static constexpr qint64 maxBatchDuration = 20; /**< The maximum time in ms to update the simulation before control is returned to the event loop. */
+  unsigned int updatePeriod = 0; /**< The time between two updates of the simulation in microseconds while running (0 means as fast as possible). */
+  qint64 simulationCpuTime = 0; /**< The CPU time in nanoseconds spent in updating the modules since \c loadTimer was started. */
+  qint64 loadStartCpuTime = 0; /**< The CPU time in nanoseconds of the GUI thread when \c loadTimer was started. */
+  QElapsedTimer loadTimer; /**< Measures the real time over which the CPU times are summed up. */
+  int simulationLoad = 0; /**< The share of the CPU time spent in updating the modules in percent of the real time. */
+  int guiLoad = 0; /**< The share of the CPU time spent otherwise by the GUI thread in percent of the real time. */
 
   QAction* fileOpenAct;
   QAction* fileCloseAct;
@@ -146,6 +160,13 @@ private:
   bool loadModule(const QString& name, bool manually);
   void unloadModule(const QString& name);
   bool compileModules();
+
+  /** Starts the timer that updates the simulation, either paced as requested by the modules or as fast as possible. */
+  void startUpdateTimer();
+
+  /** Computes the CPU shares of updating the modules and of the GUI once per second. */
+  void updateLoad();
+
   void updateViewMenu(QMenu* menu);
   void addToolBarButtonsFromMenu(QMenu* menu, QToolBar* toolBar, bool addSeparator);
 
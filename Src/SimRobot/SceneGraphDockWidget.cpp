@@ -1,36 +1,44 @@
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QHeaderView>
 #include <QSettings>
 #include <QAction>
 #include <QContextMenuEvent>
 #include <QMenu>
 #include <QApplication>
+#include <algorithm>
 
 #include "SceneGraphDockWidget.h"
 #include "MainWindow.h"
 #include "Theme.h"
 
-SceneGraphDockWidget::SceneGraphDockWidget(QMenu* contextMenu, QWidget* parent) : QDockWidget(parent), contextMenu(contextMenu)
+SceneGraphDockWidget::SceneGraphDockWidget(QMenu* contextMenu, QWidget* parent) :
+  QDockWidget(parent), contextMenu(contextMenu), model(*this), root(nullptr, nullptr, nullptr, 0)
 {
+  root.fetched = true;
+
   setFeatures(features() & ~DockWidgetFloatable);
   setAllowedAreas(Qt::TopDockWidgetArea);
   setFocusPolicy(Qt::ClickFocus);
   setObjectName(".SceneGraph");
   setWindowTitle(tr("Scene Graph"));
-  treeWidget = new QTreeWidget(this);
-  italicFont = treeWidget->font();
+  treeView = new QTreeView(this);
+  treeView->setModel(&model);
+  italicFont = treeView->font();
   italicFont.setItalic(true);
-  boldFont = treeWidget->font();
+  boldFont = treeView->font();
   boldFont.setBold(true);
-  treeWidget->setFrameStyle(QFrame::NoFrame);
-  setWidget(treeWidget);
-  setFocusProxy(treeWidget);
-  treeWidget->setExpandsOnDoubleClick(false);
-  treeWidget->setHeaderHidden(true);
-
-  connect(treeWidget, &QTreeWidget::activated, this, &SceneGraphDockWidget::itemActivated);
-  connect(treeWidget, &QTreeWidget::collapsed, this, &SceneGraphDockWidget::itemCollapsed);
-  connect(treeWidget, &QTreeWidget::expanded, this, &SceneGraphDockWidget::itemExpanded);
+  treeView->setFrameStyle(QFrame::NoFrame);
+  setWidget(treeView);
+  setFocusProxy(treeView);
+  treeView->setExpandsOnDoubleClick(false);
+  treeView->setHeaderHidden(true);
+  treeView->setUniformRowHeights(true);
+  treeView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+
+  connect(treeView, &QTreeView::activated, this, &SceneGraphDockWidget::itemActivated);
+  connect(treeView, &QTreeView::collapsed, this, &SceneGraphDockWidget::itemCollapsed);
+  connect(treeView, &QTreeView::expanded, this, &SceneGraphDockWidget::itemExpanded);
+  connect(&model, &QAbstractItemModel::rowsInserted, this, &SceneGraphDockWidget::rowsInserted);
 
   // load layout settings
   QSettings& settings = MainWindow::application->getLayoutSettings();
@@ -51,28 +59,34 @@ SceneGraphDockWidget::~SceneGraphDockWidget()
   //
   unregisterAllObjects();
   Q_ASSERT(registeredObjectsByKindAndName.isEmpty());
+
+  // the view must not outlive the model
+  delete treeView;
 }
 
 void SceneGraphDockWidget::registerObject(const SimRobot::Module* module, SimRobot::Object* object, const SimRobot::Object* parent, int flags)
 {
-  QTreeWidgetItem* parentItem = parent ? registeredObjectsByObject.value(parent) : treeWidget->invisibleRootItem();
-  RegisteredObject* newItem = new RegisteredObject(module, object, parentItem, flags);
-  const auto parentFullNameLength = parent ? static_cast<RegisteredObject*>(parentItem)->fullName.length() : 0;
-  newItem->setText(0, parent ? newItem->fullName.mid(parentFullNameLength + 1) : newItem->fullName);
-  const QIcon* icon = object->getIcon();
-  if(icon)
-    newItem->setIcon(0, Theme::updateIcon(this, *icon));
-  if(flags & SimRobot::Flag::hidden)
-    newItem->setHidden(true);
-  if(flags & SimRobot::Flag::windowless)
-    newItem->setFont(0, italicFont);
-  parentItem->addChild(newItem);
+  RegisteredObject* parentObject = parent ? registeredObjectsByObject.value(parent) : &root;
+  Q_ASSERT(parentObject);
+  RegisteredObject* newObject = new RegisteredObject(module, object, parent ? parentObject : nullptr, flags);
+  newObject->name = parent ? newObject->fullName.mid(parentObject->fullName.length() + 1) : newObject->fullName;
+
+  // insert the node at its sorted position (instead of sorting all children again)
+  std::vector<RegisteredObject*>& children = parentObject->children;
   if(!parent || (flags & SimRobot::Flag::sorted))
-    parentItem->sortChildren(0, Qt::AscendingOrder);
-  if(expandedItems.contains(newItem->fullName))
-    treeWidget->expandItem(newItem);
+    children.insert(std::upper_bound(children.begin(), children.end(), newObject,
+                                     [](const RegisteredObject* a, const RegisteredObject* b) {return a->name < b->name;}), newObject);
+  else
+    children.push_back(newObject);
 
-  registeredObjectsByObject.insert(object, newItem);
+  // the view only learns about the node if its parent was already expanded
+  if(!newObject->hidden)
+  {
+    newObject->hidden = true;
+    model.show(newObject);
+  }
+
+  registeredObjectsByObject.insert(object, newObject);
 
   int kind = object->getKind();
   QHash<QString, RegisteredObject*>* registeredObjectsByName = registeredObjectsByKindAndName.value(kind);
@@ -82,28 +96,29 @@ void SceneGraphDockWidget::registerObject(const SimRobot::Module* module, SimRob
     registeredObjectsByKindAndName.insert(kind, registeredObjectsByName);
   }
 
-  registeredObjectsByName->insert(newItem->fullName, newItem);
+  registeredObjectsByName->insert(newObject->fullName, newObject);
 
   if(flags & SimRobot::Flag::showParent)
-    while(parentItem)
-    {
-      parentItem->setHidden(false);
-      parentItem = parentItem->parent();
-    }
+    for(RegisteredObject* ancestor = newObject->parent; ancestor; ancestor = ancestor->parent)
+      model.show(ancestor);
 }
 
 void SceneGraphDockWidget::unregisterAllObjects()
 {
-  registeredObjectsByObject.clear();
-  qDeleteAll(registeredObjectsByKindAndName);
-  registeredObjectsByKindAndName.clear();
-  treeWidget->clear();
+  model.beginResetModel();
+  for(RegisteredObject* registeredObject : root.children)
+    deleteSubtree(registeredObject);
+  root.children.clear();
+  root.rows.clear();
+  Q_ASSERT(registeredObjectsByObject.isEmpty());
+  Q_ASSERT(registeredObjectsByKindAndName.isEmpty());
+  model.endResetModel();
 }
 
 void SceneGraphDockWidget::unregisterObjectsFromModule(const SimRobot::Module* module)
 {
-  for(int i = treeWidget->topLevelItemCount() - 1; i >= 0; --i)
-    deleteRegisteredObjectsFromModule(static_cast<RegisteredObject*>(treeWidget->topLevelItem(i)), module);
+  for(auto i = static_cast<int>(root.children.size()) - 1; i >= 0; --i)
+    deleteRegisteredObjectsFromModule(root.children[i], module);
 }
 
 bool SceneGraphDockWidget::unregisterObject(const SimRobot::Object* object)
@@ -150,7 +165,7 @@ SimRobot::Object* SceneGraphDockWidget::resolveObject(const SimRobot::Object* pa
         RegisteredObject* currentObject = object;
         for(auto i = partsCount - 2; i >= 0; --i)
         {
-          currentObject = static_cast<RegisteredObject*>(currentObject->parent());
+          currentObject = currentObject->parent;
           const QString& currentPart = parts.at(i);
           for(;;)
           {
@@ -158,19 +173,19 @@ SimRobot::Object* SceneGraphDockWidget::resolveObject(const SimRobot::Object* pa
               goto continueSearch;
             if(currentObject->fullName.endsWith(currentPart))
               break;
-            currentObject = static_cast<RegisteredObject*>(currentObject->parent());
+            currentObject = currentObject->parent;
           }
         }
         if(parent)
         {
-          currentObject = static_cast<RegisteredObject*>(currentObject->parent());
+          currentObject = currentObject->parent;
           for(;;)
           {
             if(!currentObject)
               goto continueSearch;
             if(currentObject->object == parent)
               break;
-            currentObject = static_cast<RegisteredObject*>(currentObject->parent());
+            currentObject = currentObject->parent;
           }
         }
         return object->object;
@@ -188,20 +203,20 @@ SimRobot::Object* SceneGraphDockWidget::resolveObject(const SimRobot::Object* pa
 int SceneGraphDockWidget::getObjectChildCount(const SimRobot::Object* object)
 {
   const RegisteredObject* item = registeredObjectsByObject.value(object);
-  return item ? item->childCount() : 0;
+  return item ? static_cast<int>(item->children.size()) : 0;
 }
 
 SimRobot::Object* SceneGraphDockWidget::getObjectChild(const SimRobot::Object* object, int index)
 {
   const RegisteredObject* item = registeredObjectsByObject.value(object);
-  return item && index >= 0 && index < item->childCount() ? static_cast<RegisteredObject*>(item->child(index))->object : 0;
+  return item && index >= 0 && index < static_cast<int>(item->children.size()) ? item->children[index]->object : 0;
 }
 
 bool SceneGraphDockWidget::activateFirstObject()
 {
-  RegisteredObject* item = static_cast<RegisteredObject*>(treeWidget->invisibleRootItem()->child(0));
-  if(!item)
+  if(root.children.empty())
     return false;
+  RegisteredObject* item = root.children.front();
   emit activatedObject(item->fullName, item->module, item->object, item->flags);
   return true;
 }
@@ -221,19 +236,22 @@ bool SceneGraphDockWidget::setOpened(const SimRobot::Object* object, bool opened
   if(!item)
     return false;
   item->opened = opened;
-  item->setFont(0, opened ? boldFont : QFont());
+  model.update(item);
   if(!opened)
-    item->setSelected(false);
+    if(const QModelIndex index = model.indexOf(item); index.isValid())
+      treeView->selectionModel()->select(index, QItemSelectionModel::Deselect);
   return true;
 }
 
 bool SceneGraphDockWidget::setActive(const SimRobot::Object* object, bool active)
 {
-  treeWidget->selectionModel()->clearSelection();
+  treeView->selectionModel()->clearSelection();
   RegisteredObject* item = registeredObjectsByObject.value(object);
   if(!item)
     return false;
-  item->setSelected(active);
+  if(active)
+    if(const QModelIndex index = materialize(item); index.isValid())
+      treeView->selectionModel()->select(index, QItemSelectionModel::Select);
   return true;
 }
 
@@ -249,19 +267,43 @@ QAction* SceneGraphDockWidget::toggleViewAction() const
   return action;
 }
 
+QModelIndex SceneGraphDockWidget::materialize(RegisteredObject* registeredObject)
+{
+  std::vector<RegisteredObject*> ancestors;
+  for(RegisteredObject* ancestor = registeredObject->parent; ancestor; ancestor = ancestor->parent)
+    ancestors.push_back(ancestor);
+  for(auto i = ancestors.rbegin(); i != ancestors.rend(); ++i)
+  {
+    const QModelIndex index = model.indexOf(*i);
+    if(!index.isValid())
+      return QModelIndex();
+    if(model.canFetchMore(index))
+      model.fetchMore(index);
+  }
+  return model.indexOf(registeredObject);
+}
+
 void SceneGraphDockWidget::deleteRegisteredObjectsFromModule(RegisteredObject* registeredObject, const SimRobot::Module* module)
 {
   if(registeredObject->module == module)
     deleteRegisteredObject(registeredObject);
   else
-    for(int i = registeredObject->childCount() - 1; i >= 0; --i)
-      deleteRegisteredObjectsFromModule(static_cast<RegisteredObject*>(registeredObject->child(i)), module);
+    for(auto i = static_cast<int>(registeredObject->children.size()) - 1; i >= 0; --i)
+      deleteRegisteredObjectsFromModule(registeredObject->children[i], module);
 }
 
 void SceneGraphDockWidget::deleteRegisteredObject(RegisteredObject* registeredObject)
 {
-  for(int i = registeredObject->childCount() - 1; i >= 0; --i)
-    deleteRegisteredObject(static_cast<RegisteredObject*>(registeredObject->child(i)));
+  model.hide(registeredObject);
+  std::vector<RegisteredObject*>& siblings = getParent(registeredObject)->children;
+  siblings.erase(std::find(siblings.begin(), siblings.end(), registeredObject));
+  deleteSubtree(registeredObject);
+}
+
+void SceneGraphDockWidget::deleteSubtree(RegisteredObject* registeredObject)
+{
+  for(RegisteredObject* child : registeredObject->children)
+    deleteSubtree(child);
   registeredObjectsByObject.remove(registeredObject->object);
   int kind = registeredObject->object->getKind();
   QHash<QString, RegisteredObject*>* registeredObjectsByName = registeredObjectsByKindAndName.value(kind);
@@ -279,7 +321,7 @@ void SceneGraphDockWidget::deleteRegisteredObject(RegisteredObject* registeredOb
 
 void SceneGraphDockWidget::contextMenuEvent(QContextMenuEvent* event)
 {
-  const QRect content(treeWidget->geometry());
+  const QRect content(treeView->geometry());
   if(!content.contains(event->x(), event->y()))
   {
     // click on window frame
@@ -287,7 +329,8 @@ void SceneGraphDockWidget::contextMenuEvent(QContextMenuEvent* event)
     return;
   }
 
-  clickedItem = static_cast<RegisteredObject*>(treeWidget->itemAt(treeWidget->mapFromParent(event->pos())));
+  const QModelIndex index = treeView->indexAt(treeView->viewport()->mapFrom(this, event->pos()));
+  clickedItem = index.isValid() ? model.objectAt(index) : nullptr;
 
   QMenu menu;
   if(clickedItem)
@@ -298,9 +341,9 @@ void SceneGraphDockWidget::contextMenuEvent(QContextMenuEvent* event)
       connect(action, &QAction::triggered, this, &SceneGraphDockWidget::openOrCloseObject);
       menu.addSeparator();
     }
-    if(clickedItem->childCount() > 0)
+    if(!clickedItem->children.empty())
     {
-      QAction* action = menu.addAction(tr(clickedItem->isExpanded() ? "Collaps&e" : "&Expand")); // cspell:disable-line
+      QAction* action = menu.addAction(tr(treeView->isExpanded(index) ? "Collaps&e" : "&Expand")); // cspell:disable-line
       connect(action, &QAction::triggered, this, &SceneGraphDockWidget::expandOrCollapseObject);
       menu.addSeparator();
     }
@@ -315,22 +358,20 @@ void SceneGraphDockWidget::changeEvent(QEvent* event)
 {
   if(event->type() == QEvent::PaletteChange)
   {
-    for(QTreeWidgetItem* item : treeWidget->findItems(QString("*"), Qt::MatchWrap | Qt::MatchWildcard | Qt::MatchRecursive))
-      if(!item->icon(0).isNull())
-        item->setIcon(0, Theme::updateIcon(this, item->icon(0)));
+    // the icons are adapted to the theme again when they are shown
+    for(RegisteredObject* registeredObject : registeredObjectsByObject)
+      registeredObject->icon = QIcon();
+    treeView->viewport()->update();
   }
   QDockWidget::changeEvent(event);
 }
 
 void SceneGraphDockWidget::itemActivated(const QModelIndex& index)
 {
-  RegisteredObject* item = static_cast<RegisteredObject*>(index.internalPointer());
+  RegisteredObject* item = model.objectAt(index);
   if(item->flags & SimRobot::Flag::windowless)
   {
-    if(item->isExpanded())
-      treeWidget->collapseItem(item);
-    else
-      treeWidget->expandItem(item);
+    treeView->setExpanded(index, !treeView->isExpanded(index));
     // the object does not have a widget, but it might have a simple
     // widget-less callback - call it (by default an empty callback
     // stub is provided)
@@ -342,14 +383,21 @@ void SceneGraphDockWidget::itemActivated(const QModelIndex& index)
 
 void SceneGraphDockWidget::itemCollapsed(const QModelIndex& index)
 {
-  RegisteredObject* item = static_cast<RegisteredObject*>(index.internalPointer());
-  expandedItems.remove(item->fullName);
+  expandedItems.remove(model.objectAt(index)->fullName);
 }
 
 void SceneGraphDockWidget::itemExpanded(const QModelIndex& index)
 {
-  RegisteredObject* item = static_cast<RegisteredObject*>(index.internalPointer());
-  expandedItems.insert(item->fullName);
+  expandedItems.insert(model.objectAt(index)->fullName);
+}
+
+void SceneGraphDockWidget::rowsInserted(const QModelIndex& parent, int first, int last)
+{
+  // restore the expansion state of the new rows, which creates their children in turn
+  const RegisteredObject* parentObject = model.objectAt(parent);
+  for(int row = first; row <= last; ++row)
+    if(expandedItems.contains(parentObject->rows[row]->fullName))
+      treeView->expand(model.index(row, 0, parent));
 }
 
 void SceneGraphDockWidget::openOrCloseObject()
@@ -362,8 +410,147 @@ void SceneGraphDockWidget::openOrCloseObject()
 
 void SceneGraphDockWidget::expandOrCollapseObject()
 {
-  if(clickedItem->isExpanded())
-    treeWidget->collapseItem(clickedItem);
-  else
-    treeWidget->expandItem(clickedItem);
+  const QModelIndex index = materialize(clickedItem);
+  treeView->setExpanded(index, !treeView->isExpanded(index));
+}
+
+QModelIndex SceneGraphDockWidget::Model::index(int row, int column, const QModelIndex& parent) const
+{
+  const RegisteredObject* parentObject = objectAt(parent);
+  if(row < 0 || column != 0 || !parentObject->fetched || row >= static_cast<int>(parentObject->rows.size()))
+    return QModelIndex();
+  return createIndex(row, 0, parentObject->rows[row]);
+}
+
+QModelIndex SceneGraphDockWidget::Model::parent(const QModelIndex& index) const
+{
+  return index.isValid() ? indexOf(objectAt(index)->parent) : QModelIndex();
+}
+
+int SceneGraphDockWidget::Model::rowCount(const QModelIndex& parent) const
+{
+  if(parent.column() > 0)
+    return 0;
+  const RegisteredObject* parentObject = objectAt(parent);
+  return parentObject->fetched ? static_cast<int>(parentObject->rows.size()) : 0;
+}
+
+bool SceneGraphDockWidget::Model::hasChildren(const QModelIndex& parent) const
+{
+  return !objectAt(parent)->rows.empty();
+}
+
+bool SceneGraphDockWidget::Model::canFetchMore(const QModelIndex& parent) const
+{
+  const RegisteredObject* parentObject = objectAt(parent);
+  return !parentObject->fetched && !parentObject->rows.empty();
+}
+
+void SceneGraphDockWidget::Model::fetchMore(const QModelIndex& parent)
+{
+  RegisteredObject* parentObject = objectAt(parent);
+  if(parentObject->fetched)
+    return;
+  if(parentObject->rows.empty())
+  {
+    parentObject->fetched = true;
+    return;
+  }
+  beginInsertRows(parent, 0, static_cast<int>(parentObject->rows.size()) - 1);
+  parentObject->fetched = true;
+  endInsertRows();
+}
+
+QVariant SceneGraphDockWidget::Model::data(const QModelIndex& index, int role) const
+{
+  if(!index.isValid())
+    return QVariant();
+  const RegisteredObject* registeredObject = objectAt(index);
+  switch(role)
+  {
+    case Qt::DisplayRole:
+      return registeredObject->name;
+    case Qt::DecorationRole:
+      if(registeredObject->icon.isNull())
+        if(const QIcon* icon = registeredObject->object->getIcon(); icon)
+          registeredObject->icon = Theme::updateIcon(&sceneGraph, *icon);
+      return registeredObject->icon;
+    case Qt::FontRole:
+      if(registeredObject->opened)
+        return sceneGraph.boldFont;
+      if(registeredObject->flags & SimRobot::Flag::windowless)
+        return sceneGraph.italicFont;
+      return QVariant();
+    default:
+      return QVariant();
+  }
+}
+
+QModelIndex SceneGraphDockWidget::Model::indexOf(const RegisteredObject* registeredObject) const
+{
+  if(!registeredObject || registeredObject->row < 0 || !sceneGraph.getParent(registeredObject)->fetched)
+    return QModelIndex();
+  return createIndex(registeredObject->row, 0, const_cast<RegisteredObject*>(registeredObject));
+}
+
+SceneGraphDockWidget::RegisteredObject* SceneGraphDockWidget::Model::objectAt(const QModelIndex& index) const
+{
+  return index.isValid() ? static_cast<RegisteredObject*>(index.internalPointer()) : &sceneGraph.root;
+}
+
+void SceneGraphDockWidget::Model::show(RegisteredObject* registeredObject)
+{
+  if(!registeredObject->hidden)
+    return;
+  registeredObject->hidden = false;
+
+  // the row is the number of visible siblings in front of the object (which is quick to determine when it was appended)
+  RegisteredObject* parentObject = sceneGraph.getParent(registeredObject);
+  std::vector<RegisteredObject*>& rows = parentObject->rows;
+  int row = static_cast<int>(rows.size());
+  if(parentObject->children.back() != registeredObject)
+  {
+    row = 0;
+    for(const RegisteredObject* sibling : parentObject->children)
+    {
+      if(sibling == registeredObject)
+        break;
+      if(!sibling->hidden)
+        ++row;
+    }
+  }
+
+  if(parentObject->fetched)
+    beginInsertRows(indexOf(parentObject), row, row);
+  rows.insert(rows.begin() + row, registeredObject);
+  for(auto i = rows.begin() + row; i != rows.end(); ++i)
+    (*i)->row = static_cast<int>(i - rows.begin());
+  if(parentObject->fetched)
+    endInsertRows();
+  else if(rows.size() == 1)
+    update(parentObject); // the parent got an expansion indicator
+}
+
+void SceneGraphDockWidget::Model::hide(RegisteredObject* registeredObject)
+{
+  if(registeredObject->row < 0)
+    return;
+  RegisteredObject* parentObject = sceneGraph.getParent(registeredObject);
+  std::vector<RegisteredObject*>& rows = parentObject->rows;
+  const int row = registeredObject->row;
+  if(parentObject->fetched)
+    beginRemoveRows(indexOf(parentObject), row, row);
+  rows.erase(rows.begin() + row);
+  for(auto i = rows.begin() + row; i != rows.end(); ++i)
+    (*i)->row = static_cast<int>(i - rows.begin());
+  registeredObject->row = -1;
+  registeredObject->hidden = true;
+  if(parentObject->fetched)
+    endRemoveRows();
+}
+
+void SceneGraphDockWidget::Model::update(const RegisteredObject* registeredObject)
+{
+  if(const QModelIndex index = indexOf(registeredObject); index.isValid())
+    emit dataChanged(index, index);
 }
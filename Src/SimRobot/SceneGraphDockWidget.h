@@ -1,12 +1,17 @@
 #pragma once
 
+#include <QAbstractItemModel>
 #include <QDockWidget>
-#include <QSet>
+#include <QFont>
 #include <QHash>
-#include <QTreeWidgetItem>
+#include <QIcon>
+#include <QSet>
+#include <vector>
 
 #include "SimRobot.h"
 
+class QTreeView;
+
 class SceneGraphDockWidget : public QDockWidget
 {
   Q_OBJECT
@@ -36,31 +41,111 @@ signals:
   void deactivatedObject(const QString& fullName);
 
 private:
-  class RegisteredObject : public QTreeWidgetItem
+  /** A node of the scene graph. Nodes are cheap, the view only creates items for the rows it shows. */
+  class RegisteredObject
   {
   public:
-    RegisteredObject(const SimRobot::Module* module, SimRobot::Object* object, QTreeWidgetItem* parentItem, int flags) :
-      QTreeWidgetItem(parentItem), module(module), object(object), fullName(object->getFullName()), flags(flags), opened(false) {}
+    RegisteredObject(const SimRobot::Module* module, SimRobot::Object* object, RegisteredObject* parent, int flags) :
+      module(module), object(object), parent(parent), fullName(object ? object->getFullName() : QString()), flags(flags), hidden(flags & SimRobot::Flag::hidden) {}
 
     const SimRobot::Module* module;
     SimRobot::Object* object;
+    RegisteredObject* parent; /**< The parent node or \c nullptr for top level nodes */
     const QString fullName;
+    QString name; /**< The name shown in the scene graph (relative to the parent) */
     int flags;
-    bool opened;
+    bool opened = false;
+    bool hidden; /**< Whether the node is not shown in the scene graph */
+    bool fetched = false; /**< Whether the view already knows the rows of the children */
+    int row = -1; /**< The index of this node in the \c rows of its parent (-1 if it is hidden) */
+    std::vector<RegisteredObject*> children; /**< All children (sorted by name if requested) */
+    std::vector<RegisteredObject*> rows; /**< The children that are not hidden, in the same order */
+    mutable QIcon icon; /**< The icon adapted to the current theme (created when it is shown first) */
+  };
+
+  /** Presents the registered objects to the tree view and creates rows only when their parent is expanded */
+  class Model : public QAbstractItemModel
+  {
+  public:
+    Model(SceneGraphDockWidget& sceneGraph) : sceneGraph(sceneGraph) {}
+
+    QModelIndex index(int row, int column, const QModelIndex& parent) const override;
+    QModelIndex parent(const QModelIndex& index) const override;
+    int rowCount(const QModelIndex& parent) const override;
+    int columnCount(const QModelIndex&) const override {return 1;}
+    bool hasChildren(const QModelIndex& parent) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+    QVariant data(const QModelIndex& index, int role) const override;
+
+    /**
+     * Returns the index of a node
+     * @param registeredObject The node (or \c nullptr for the root)
+     * @return The index or an invalid index if the node is not part of the model (yet)
+     */
+    QModelIndex indexOf(const RegisteredObject* registeredObject) const;
+
+    /**
+     * Returns the node of an index
+     * @param index The index
+     * @return The node (the root for an invalid index)
+     */
+    RegisteredObject* objectAt(const QModelIndex& index) const;
+
+    /**
+     * Shows a node that was hidden
+     * @param registeredObject The node
+     */
+    void show(RegisteredObject* registeredObject);
+
+    /**
+     * Removes a node from the rows of its parent
+     * @param registeredObject The node
+     */
+    void hide(RegisteredObject* registeredObject);
+
+    /**
+     * Notifies the view that the appearance of a node changed
+     * @param registeredObject The node
+     */
+    void update(const RegisteredObject* registeredObject);
+
+    using QAbstractItemModel::beginResetModel;
+    using QAbstractItemModel::endResetModel;
+
+  private:
+    SceneGraphDockWidget& sceneGraph;
   };
 
   QMenu* contextMenu;
-  QTreeWidget* treeWidget;
+  QTreeView* treeView;
+  Model model;
   QFont italicFont;
   QFont boldFont;
   QSet<QString> expandedItems;
+  RegisteredObject root; /**< The invisible root, whose children are the top level nodes */
   QHash<const void*, RegisteredObject*> registeredObjectsByObject;
   QHash<int, QHash<QString, RegisteredObject*>*> registeredObjectsByKindAndName;
 
   RegisteredObject* clickedItem = nullptr;
 
+  /**
+   * Returns the node whose children contain a node
+   * @param registeredObject The node
+   * @return The parent node or \c root
+   */
+  RegisteredObject* getParent(const RegisteredObject* registeredObject) {return registeredObject->parent ? registeredObject->parent : &root;}
+
+  /**
+   * Makes a node visible in the view, i.e. creates the rows of all its ancestors
+   * @param registeredObject The node
+   * @return The index of the node or an invalid index if it or one of its ancestors is hidden
+   */
+  QModelIndex materialize(RegisteredObject* registeredObject);
+
   void deleteRegisteredObjectsFromModule(RegisteredObject* registeredObject, const SimRobot::Module* module);
   void deleteRegisteredObject(RegisteredObject* registeredObject);
+  void deleteSubtree(RegisteredObject* registeredObject);
 
   void contextMenuEvent(QContextMenuEvent* event) override;
   void changeEvent(QEvent* event) override;
@@ -69,6 +154,7 @@ private slots:
   void itemActivated(const QModelIndex& index);
   void itemCollapsed(const QModelIndex& index);
   void itemExpanded(const QModelIndex& index);
+  void rowsInserted(const QModelIndex& parent, int first, int last);
 
   void openOrCloseObject();
   void expandOrCollapseObject();
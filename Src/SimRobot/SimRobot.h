@@ -128,6 +128,12 @@ namespace SimRobot
      * Create a menu for this module. If 0 is returned, there is no menu.
      */
     virtual QMenu* createUserMenu() const {return nullptr;}
+
+    /**
+     * Returns how often the module wants \c update to be called while the simulation is running
+     * @return The time between two updates in microseconds or 0 if updates should happen as often as possible
+     */
+    virtual unsigned int getUpdatePeriod() const {return 0;}
   };
 
   /**
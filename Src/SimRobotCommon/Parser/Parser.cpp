@@ -74,7 +74,7 @@ void Parser::handleError(const std::string& msg, const Location& location)
   errors->push_back(errorMessage.str());
 }
 
-bool Parser::handleElement(const std::string& name, Attributes& attributes, const Location& location)
+bool Parser::handleElement(std::string_view name, Attributes& attributes, const Location& location)
 {
   const auto iter = elementInfos.find(name);
   const ElementInfo* const elementInfo = iter != elementInfos.end() ? iter->second : nullptr;
@@ -83,7 +83,7 @@ bool Parser::handleElement(const std::string& name, Attributes& attributes, cons
   // The <Simulation> tag must be the outermost and there must be no other ones.
   if(!elementInfo || passedSimulationTag == !std::strcmp(elementInfo->name, "Simulation"))
   {
-    handleError("Unexpected element \"" + name + "\"", location);
+    handleError("Unexpected element \"" + std::string(name) + "\"", location);
     return readElements(false);
   }
 
@@ -183,7 +183,7 @@ bool Parser::handleElement(const std::string& name, Attributes& attributes, cons
     const bool isScene = !std::strcmp(elementInfo->name, "Scene");
     if(isScene && sceneMacro)
     {
-      handleError("Unexpected element \"" + name + "\"", location);
+      handleError("Unexpected element \"" + std::string(name) + "\"", location);
       return readElements(false);
     }
 
@@ -193,7 +193,7 @@ bool Parser::handleElement(const std::string& name, Attributes& attributes, cons
     const std::string& macroName = getString("name", true);
 
     // The full macro name is combined from its name attribute and its element name. This combination must be unique.
-    const std::string combinedMacroName = macroName + " " + name;
+    const std::string combinedMacroName = macroName + " " + std::string(name);
     if(macros.find(combinedMacroName) != macros.end())
     {
       handleError("Duplicated name \"" + macroName + "\"", attributes.find("name")->second.valueLocation);
@@ -214,7 +214,7 @@ bool Parser::handleElement(const std::string& name, Attributes& attributes, cons
   }
 }
 
-void Parser::handleText(std::string& text, const Location& location)
+void Parser::handleText(std::string_view text, const Location& location)
 {
   // Only add text / data to element types that allow for it.
   if(!recordingMacroElement || !(recordingMacroElement->elementInfo->flags & textFlag))
@@ -225,7 +225,7 @@ void Parser::handleText(std::string& text, const Location& location)
 
   // Add the text / data to the macro element being recorded.
   ASSERT(recordingMacroElement->text.empty());
-  recordingMacroElement->text.swap(text);
+  recordingMacroElement->text = text;
   recordingMacroElement->textLocation = location;
 }
 
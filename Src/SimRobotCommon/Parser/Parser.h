@@ -37,6 +37,12 @@ public:
    */
   bool parse(const std::string& fileName, std::list<std::string>& errors);
 
+  /**
+   * Returns the names of all files that were read during parsing (the root file and all included files).
+   * @return The file names.
+   */
+  const std::vector<std::string>& getFileNames() const {return readFileNames;}
+
 protected:
   using StartElementProc = std::function<Element*()>;
   using TextProc = std::function<void(std::string&, Location)>;
@@ -113,7 +119,14 @@ protected:
   Element* simulationElement();
   Element* includeElement();
 
-  std::unordered_map<std::string, const ElementInfo*> elementInfos; /**< Mapping element name strings to handler info. */
+  /** A string hash that also accepts string views, so that element names can be looked up without creating a string. */
+  struct NameHash
+  {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view name) const {return std::hash<std::string_view>()(name);}
+  };
+
+  std::unordered_map<std::string, const ElementInfo*, NameHash, std::equal_to<>> elementInfos; /**< Mapping element name strings to handler info. */
 
   Element* element = nullptr; /**< The last inserted XML element. */
   ElementData* elementData = nullptr; /**< Element context data required for parsing an XML element. */
@@ -170,14 +183,14 @@ private:
    * @param location The location of the element.
    * @return Whether subordinate elements could be read successfully.
    */
-  bool handleElement(const std::string& name, Attributes& attributes, const Location& location) override;
+  bool handleElement(std::string_view name, Attributes& attributes, const Location& location) override;
 
   /**
    * Handler for text / data.
    * @param text The text / data to be handled.
    * @param location The location of the text / data.
    */
-  void handleText(std::string& text, const Location& location) override;
+  void handleText(std::string_view text, const Location& location) override;
 
   /** Checks if there are any unexpected attributes in the current set of attributes. */
   void checkAttributes();
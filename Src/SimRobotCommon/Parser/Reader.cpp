@@ -27,23 +27,115 @@
 #include "Reader.h"
 #include "Platform/Assert.h"
 #include <cctype>
-#include <fstream>
-#include <iostream>
+#include <cstring>
+
+#ifdef WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+  /** A read-only memory mapping of a whole file. */
+  class MappedFile
+  {
+  public:
+    /**
+     * Maps a file.
+     * @param fileName The name of the file
+     */
+    MappedFile(const std::string& fileName)
+    {
+#ifdef WINDOWS
+      file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+      if(file == INVALID_HANDLE_VALUE)
+        return;
+      LARGE_INTEGER fileSize;
+      if(!GetFileSizeEx(file, &fileSize))
+        return;
+      size = static_cast<std::size_t>(fileSize.QuadPart);
+      isOpen = true;
+      if(!size)
+        return;
+      mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if(mapping)
+        data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+      const int fd = open(fileName.c_str(), O_RDONLY);
+      if(fd == -1)
+        return;
+      struct stat fileStat;
+      if(fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode))
+      {
+        size = static_cast<std::size_t>(fileStat.st_size);
+        isOpen = true;
+        if(size)
+        {
+          void* memory = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+          if(memory != MAP_FAILED)
+            data = static_cast<const char*>(memory);
+        }
+      }
+      close(fd);
+#endif
+      if(!data)
+        isOpen = isOpen && !size;
+    }
+
+    /** Unmaps the file. */
+    ~MappedFile()
+    {
+#ifdef WINDOWS
+      if(data)
+        UnmapViewOfFile(data);
+      if(mapping)
+        CloseHandle(mapping);
+      if(file != INVALID_HANDLE_VALUE)
+        CloseHandle(file);
+#else
+      if(data)
+        munmap(const_cast<char*>(data), size);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen = false; /**< Whether the file could be opened and mapped */
+    const char* data = nullptr; /**< The contents of the file (\c nullptr if it is empty) */
+    std::size_t size = 0; /**< The size of the file in bytes */
+
+  private:
+#ifdef WINDOWS
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+  };
+}
 
 bool Reader::readFile(const std::string& fileName)
 {
-  // open file
-  std::ifstream reader(fileName);
-  if(!reader.is_open())
+  // map file
+  const MappedFile file(fileName);
+  if(!file.isOpen)
     return false;
+  readFileNames.push_back(fileName);
 
   // backup reader state
   std::string oldFileName = fileName;
   const Location oldLocation = location;
   const Location oldNextLocation = nextLocation;
+  const char* const oldCurrent = current;
+  const char* const oldEnd = end;
 
   // set new reader state
-  this->reader.swap(reader);
+  static const char emptyFile = 0;
+  current = file.data ? file.data : &emptyFile;
+  end = current + file.size;
   this->fileName.swap(oldFileName);
   nextLocation = location = Location(1, 1);
   ASSERT(nextToken == invalidToken);
@@ -51,9 +143,6 @@ bool Reader::readFile(const std::string& fileName)
   // read root elements
   bool result = readElements(true, true);
 
-  // close reader
-  this->reader.close();
-
   // restore old reader state
   if(!oldFileName.empty())
   {
@@ -62,14 +151,15 @@ bool Reader::readFile(const std::string& fileName)
     nextLocation = oldNextLocation;
   }
   nextToken = invalidToken;
-  this->reader.swap(reader);
+  current = oldCurrent;
+  end = oldEnd;
 
   return result;
 }
 
 bool Reader::readElements(bool callHandler, bool isRoot)
 {
-  if(!reader.is_open()) // the last element was "empty"
+  if(!current) // the last element was "empty"
     return true;
 
   Token token;
@@ -116,9 +206,9 @@ bool Reader::readElement(bool callHandler)
   if(token == tagStart)
   {
     Location nameLocation;
-    if(!readName(nameLocation))
+    std::string_view name;
+    if(!readName(nameLocation, name))
       return false;
-    const std::string name = tmpString;
     attributes.clear();
     if(!readAttributes())
       return false;
@@ -128,10 +218,10 @@ bool Reader::readElement(bool callHandler)
       if(callHandler)
       {
         // This signals further calls to readElements that there is nothing to read
-        std::ifstream f;
-        reader.swap(f);
+        const char* const savedCurrent = current;
+        current = nullptr;
         handleElement(name, attributes, nameLocation);
-        reader.swap(f);
+        current = savedCurrent;
       }
       return true;
     }
@@ -151,9 +241,9 @@ bool Reader::readElement(bool callHandler)
       if(token == endTagStart)
       {
         Location endNameLocation;
-        if(!readName(endNameLocation))
+        std::string_view endName;
+        if(!readName(endNameLocation, endName))
           return false;
-        const std::string& endName = tmpString;
         while(tokenIsSpace(token = readToken()));
         if(token == tagEnd)
         {
@@ -227,9 +317,9 @@ bool Reader::readAttributes()
 bool Reader::readAttribute()
 {
   Location nameLocation;
-  if(!readName(nameLocation))
+  std::string_view name;
+  if(!readName(nameLocation, name))
     return false;
-  const std::string name = tmpString;
   Token token;
   while(tokenIsSpace(token = readToken()));
   if(token == equals)
@@ -237,10 +327,11 @@ bool Reader::readAttribute()
     while(tokenIsSpace(token = readToken()));
     undoReadToken(token);
     Location valueLocation;
-    if(!readString(valueLocation))
+    std::string_view value;
+    if(!readString(valueLocation, value))
       return false;
-    const std::string& value = tmpString;
-    attributes.emplace(name, Attribute(value, static_cast<unsigned int>(attributes.size()), nameLocation, valueLocation));
+    // The attributes are copied, because macros keep them after the file has been unmapped.
+    attributes.emplace(std::string(name), Attribute(value, static_cast<unsigned int>(attributes.size()), nameLocation, valueLocation));
     return true;
   }
   else
@@ -253,7 +344,7 @@ bool Reader::readAttribute()
   }
 }
 
-bool Reader::readName(Location& location)
+bool Reader::readName(Location& location, std::string_view& name)
 {
   Token token = readToken();
   if(token >= firstNonCharToken || (!std::isalpha(static_cast<unsigned char>(token)) && token != underscore && token != colon))
@@ -267,21 +358,20 @@ bool Reader::readName(Location& location)
     return false;
   }
   location = this->location;
-  tmpString.clear();
-  tmpString += static_cast<char>(token);
-  for(;;)
-  {
-    token = readToken();
-    if(token >= firstNonCharToken || (!std::isalnum(static_cast<unsigned char>(token)) && token != dot && token != dash && token != underscore && token != colon))
-    {
-      undoReadToken(token);
-      return true;
-    }
-    tmpString += static_cast<char>(token);
-  }
+
+  // The characters of a name are ASCII and never form multi-character tokens, so the name can be taken directly from the input.
+  ASSERT(nextToken == invalidToken);
+  const char* const start = current - 1;
+  const char* position = current;
+  while(position != end && (std::isalnum(static_cast<unsigned char>(*position)) || *position == dot || *position == underscore || *position == colon ||
+                            (*position == dash && !(end - position >= 3 && position[1] == '-' && position[2] == '>'))))
+    ++position;
+  skipTo(position);
+  name = std::string_view(start, static_cast<std::size_t>(position - start));
+  return true;
 }
 
-bool Reader::readString(Location& location)
+bool Reader::readString(Location& location, std::string_view& value)
 {
   Token token = readToken();
   if(token != doubleQuote)
@@ -295,6 +385,20 @@ bool Reader::readString(Location& location)
     return false;
   }
   const Location startQuoteLocation = this->location;
+
+  // Most strings do not contain escapes, so they can be taken directly from the input.
+  ASSERT(nextToken == invalidToken);
+  const char* position = current;
+  while(position != end && *position != '"' && *position != '\\')
+    ++position;
+  if(position != end && *position == '"')
+  {
+    location = nextLocation;
+    value = std::string_view(current, static_cast<std::size_t>(position - current));
+    skipTo(position + 1);
+    return true;
+  }
+
   bool wroteLocation = false;
   tmpString.clear();
   bool escaped = false;
@@ -322,39 +426,58 @@ bool Reader::readString(Location& location)
   }
   if(!wroteLocation)
     location = this->location;
+  value = tmpString;
   return true;
 }
 
 bool Reader::readData(bool callHandler)
 {
-  tmpString.clear();
   Token token = readToken();
   // This function is only called if the next token is not one of the ones below.
   ASSERT(token != endOfInput && token != tagStart && token != endTagStart);
   const Location dataLocation = location;
-  if(static_cast<int>(token) < firstNonCharToken)
-    tmpString += static_cast<char>(token);
-  else
-    tmpString += nonCharTokenToString(token);
-  while((token = readToken()) != endTagStart && token != tagStart)
+  const char* const start = current - (static_cast<int>(token) < firstNonCharToken ? 1 : nonCharTokenToString(token).size());
+
+  // Data blocks (e.g. mesh data) can be huge, so search for the next tag directly in the input instead of going through readToken.
+  // Only comment starts (which are part of the data) can be skipped.
+  ASSERT(nextToken == invalidToken);
+  const char* position = current;
+  for(;;)
   {
-    if(token == endOfInput)
+    position = static_cast<const char*>(std::memchr(position, '<', static_cast<std::size_t>(end - position)));
+    if(!position)
     {
+      skipTo(end);
       handleError("Unterminated data block (there must be a tag somewhere)", dataLocation);
       return false;
     }
-    if(static_cast<int>(token) < firstNonCharToken)
-      tmpString += static_cast<char>(token);
+    if(end - position >= 4 && position[1] == '!' && position[2] == '-' && position[3] == '-')
+      position += 4;
     else
-      tmpString += nonCharTokenToString(token);
+      break;
   }
-  undoReadToken(token);
+  skipTo(position);
 
   if(callHandler)
-    handleText(tmpString, dataLocation);
+    handleText(std::string_view(start, static_cast<std::size_t>(position - start)), dataLocation);
   return true;
 }
 
+void Reader::skipTo(const char* position)
+{
+  ASSERT(nextToken == invalidToken);
+  for(; current != position; ++current)
+  {
+    if(*current == '\n')
+    {
+      ++nextLocation.line;
+      nextLocation.column = 1;
+    }
+    else if((*current & 0xc0) != 0x80) // This handles UTF-8 continuation characters.
+      ++nextLocation.column;
+  }
+}
+
 Reader::Token Reader::readToken()
 {
   prevLocation = location;
@@ -366,10 +489,9 @@ Reader::Token Reader::readToken()
     nextLocation = nextNextLocation;
     return token;
   }
-  const char c = static_cast<char>(reader.get());
-  if(!reader.good())
+  if(current == end)
     return endOfInput;
-  ASSERT(c != static_cast<char>(EOF));
+  const char c = *current++;
   if(c == '\n')
   {
     ++nextLocation.line;
@@ -377,53 +499,38 @@ Reader::Token Reader::readToken()
   }
   else if((c & 0xc0) != 0x80) // This handles UTF-8 continuation characters.
     ++nextLocation.column;
+  const std::ptrdiff_t remaining = end - current;
   if(c == '<')
   {
-    char nextC = static_cast<char>(reader.peek());
-    if(nextC == '/')
+    if(remaining >= 1 && current[0] == '/')
     {
-      reader.get();
+      ++current;
       ++nextLocation.column;
       return endTagStart;
     }
-    else if(nextC == '!')
+    else if(remaining >= 3 && current[0] == '!' && current[1] == '-' && current[2] == '-')
     {
-      reader.get();
-      if(reader.peek() == '-')
-      {
-        reader.get();
-        if(reader.peek() == '-')
-        {
-          reader.get();
-          nextLocation.column += 3;
-          return commentStart;
-        }
-        reader.putback('-');
-      }
-      reader.putback('!');
+      current += 3;
+      nextLocation.column += 3;
+      return commentStart;
     }
   }
   else if(c == '/')
   {
-    if(reader.peek() == '>')
+    if(remaining >= 1 && current[0] == '>')
     {
-      reader.get();
+      ++current;
       ++nextLocation.column;
       return emptyTagEnd;
     }
   }
   else if(c == '-')
   {
-    if(reader.peek() == '-')
+    if(remaining >= 2 && current[0] == '-' && current[1] == '>')
     {
-      reader.get();
-      if(reader.peek() == '>')
-      {
-        reader.get();
-        nextLocation.column += 2;
-        return commentEnd;
-      }
-      reader.putback('-');
+      current += 2;
+      nextLocation.column += 2;
+      return commentEnd;
     }
   }
   return static_cast<Token>(c);
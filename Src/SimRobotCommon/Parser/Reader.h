@@ -26,9 +26,10 @@
 
 #pragma once
 
-#include <fstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 /**
  * @class Reader
@@ -46,7 +47,7 @@ protected:
 
   struct Attribute
   {
-    Attribute(const std::string& value, int index, const Location& nameLocation, const Location& valueLocation) :
+    Attribute(std::string_view value, int index, const Location& nameLocation, const Location& valueLocation) :
       value(value), index(index), nameLocation(nameLocation), valueLocation(valueLocation) {}
 
     /**
@@ -66,6 +67,7 @@ protected:
   using Attributes = std::unordered_map<std::string, Attribute>;
 
   std::string fileName; /**< The current file name */
+  std::vector<std::string> readFileNames; /**< The names of all files that belong to the scene (in the order they were opened) */
 
   /**
    * Reads a file and calls the handlers of the derived class
@@ -93,19 +95,19 @@ protected:
   /**
    * A handler called for each parsed element
    * Call \c readElements within the handler to parse subordinate elements.
-   * @param name The name of the element
+   * @param name The name of the element (only valid during the call)
    * @param attributes The attributes of the element
    * @param location The location of the element in the current file (first character after <)
    * @return The result of \c readElements that has been called inside
    */
-  virtual bool handleElement(const std::string& name, Attributes& attributes, const Location& location) = 0;
+  virtual bool handleElement(std::string_view name, Attributes& attributes, const Location& location) = 0;
 
   /**
    * A handler called when text was parsed
-   * @param text The text read
+   * @param text The text read (only valid during the call)
    * @param location The location of the text in the current file
    */
-  virtual void handleText(std::string& text, const Location& location) = 0;
+  virtual void handleText(std::string_view text, const Location& location) = 0;
 
   /**
    * Advances a string pointer and accordingly a location until a non-whitespace character is found
@@ -160,18 +162,20 @@ private:
   bool readAttribute();
 
   /**
-   * Reads a name from the stream and writes it to \c tmpString
+   * Reads a name from the stream
    * @param location Is filled with the location of the name
+   * @param name Is set to the name, which refers to the mapped file
    * @return Whether a name could be read
    */
-  bool readName(Location& location);
+  bool readName(Location& location, std::string_view& name);
 
   /**
-   * Reads a string from the stream and writes it to \c tmpString
+   * Reads a string from the stream
    * @param location Is filled with the location of the first character after the quote
+   * @param value Is set to the string, which refers to the mapped file or to \c tmpString if it contains escapes
    * @return Whether a string could be read
    */
-  bool readString(Location& location);
+  bool readString(Location& location, std::string_view& value);
 
   /**
    * Reads arbitrary text until the next tag is encountered
@@ -180,6 +184,13 @@ private:
    */
   bool readData(bool callHandler);
 
+  /**
+   * Advances the input to a position and updates the location of the next token accordingly
+   * This must only be called if no token has been put back.
+   * @param position The new position in the mapped file
+   */
+  void skipTo(const char* position);
+
   /**
    * Reads a token from the input stream and sets the current location accordingly
    * @return The token that has been read
@@ -207,12 +218,13 @@ private:
    */
   static bool tokenIsSpace(Token token);
 
-  std::ifstream reader; /**< The stream from which to read */
+  const char* current = nullptr; /**< The next character to read from the memory mapped file (\c nullptr while handling an empty element) */
+  const char* end = nullptr; /**< The end of the memory mapped file */
   Location location; /**< The location of the last token returned by readToken */
   Location nextLocation; /**< The location where the next token starts */
   Token nextToken = invalidToken; /**< The token that was put back (not saved over reentrant \c readFile calls) */
   Location prevLocation; /**< The location before the last call to readToken (needed by \c undoReadToken) */
   Location nextNextLocation; /**< The next location after the next call to readToken (filled by \c undoReadToken) */
-  std::string tmpString; /**< A string used by readName, readString and readData (not saved over reentrant \c readFile calls) */
+  std::string tmpString; /**< A string used by readString for strings with escapes (not saved over reentrant \c readFile calls) */
   Attributes attributes; /**< A storage for the attributes of an element (not saved over reentrant \c readFile calls) */
 };
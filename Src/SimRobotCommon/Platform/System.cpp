@@ -6,10 +6,12 @@
 #ifdef WINDOWS
 #include <Windows.h>
 #elif defined MACOS
+#include <dlfcn.h>
 #include <mach/mach_time.h>
 #include <unistd.h>
 #else
 #include <ctime>
+#include <dlfcn.h>
 #include <unistd.h>
 #endif
 
@@ -30,3 +32,18 @@ unsigned int System::getTime()
   return static_cast<unsigned int>(ts.tv_sec * 1000 + ts.tv_nsec / 1000000l);
 #endif
 }
+
+std::string System::getModuleFileName(const void* address)
+{
+#ifdef WINDOWS
+  HMODULE module;
+  char fileName[MAX_PATH];
+  if(!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, static_cast<LPCSTR>(address), &module))
+    return std::string();
+  const DWORD length = GetModuleFileNameA(module, fileName, MAX_PATH);
+  return length && length < MAX_PATH ? std::string(fileName, length) : std::string();
+#else
+  Dl_info info;
+  return dladdr(address, &info) && info.dli_fname ? std::string(info.dli_fname) : std::string();
+#endif
+}
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <string>
+
 /**
  * @class System
  * Collection of some basic platform-dependent system functions
@@ -18,4 +20,11 @@ public:
    * @return the time
    */
   static unsigned int getTime();
+
+  /**
+   * Returns the file name of the executable or shared library that contains an address
+   * @param address An address of code or static data
+   * @return The file name or an empty string if it could not be determined
+   */
+  static std::string getModuleFileName(const void* address);
 };
@@ -0,0 +1,28 @@
+/**
+ * @file QtTrajectoryLogCodec.h
+ * Definition of the compression of trajectory logs with Qt
+ *
+ * The codec is only defined in this header, so that SimRobotCommon does not need to link Qt. Only the modules that
+ * include it, which link Qt anyway, compile it.
+ */
+
+#pragma once
+
+#include "TrajectoryLog.h"
+#include <QByteArray>
+
+/** Compresses the chunks of trajectory logs with zlib through \c qCompress */
+inline const TrajectoryLogCodec qtTrajectoryLogCodec =
+{
+  [](const std::vector<char>& data, std::vector<char>& compressed)
+  {
+    const QByteArray result = qCompress(reinterpret_cast<const uchar*>(data.data()), static_cast<qsizetype>(data.size()));
+    compressed.assign(result.begin(), result.end());
+  },
+  [](const std::vector<char>& compressed, std::vector<char>& data)
+  {
+    const QByteArray result = qUncompress(reinterpret_cast<const uchar*>(compressed.data()), static_cast<qsizetype>(compressed.size()));
+    data.assign(result.begin(), result.end());
+    return !result.isEmpty();
+  }
+};
@@ -0,0 +1,34 @@
+/**
+ * @file StepTimer.cpp
+ * Implementation of a class that determines how many fixed-length simulation steps are due in real time
+ */
+
+#include "StepTimer.h"
+#include <algorithm>
+#include <cmath>
+
+unsigned int StepTimer::getDueSteps(float stepLength, float realTimeFactor, unsigned int maxSubSteps)
+{
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  if(started)
+    accumulator += std::chrono::duration<double>(now - lastTime).count() * realTimeFactor;
+  lastTime = now;
+  started = true;
+
+  const unsigned int steps = static_cast<unsigned int>(std::min(accumulator / stepLength, static_cast<double>(maxSubSteps)));
+  accumulator -= steps * static_cast<double>(stepLength);
+
+  // If the simulation cannot keep up, the remaining backlog is dropped.
+  if(accumulator >= stepLength)
+    accumulator = std::fmod(accumulator, static_cast<double>(stepLength));
+
+  interpolation = static_cast<float>(accumulator / stepLength);
+  return steps;
+}
+
+void StepTimer::reset()
+{
+  accumulator = 0.;
+  interpolation = 1.f;
+  started = false;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file StepTimer.h
+ * Declaration of a class that determines how many fixed-length simulation steps are due in real time
+ */
+
+#pragma once
+
+#include <chrono>
+
+/**
+ * @class StepTimer
+ * Accumulates the elapsed real time and converts it into simulation steps of a fixed length
+ */
+class StepTimer
+{
+public:
+  /**
+   * Determines how many steps are due to keep the simulated time in sync with the real time.
+   * If more than \c maxSubSteps steps are due, only these are executed and the remaining backlog is dropped.
+   * @param stepLength The simulated time of a step in s
+   * @param realTimeFactor The ratio between simulated and real time
+   * @param maxSubSteps The maximum number of steps per call
+   * @return The number of steps to execute now
+   */
+  unsigned int getDueSteps(float stepLength, float realTimeFactor, unsigned int maxSubSteps);
+
+  /**
+   * Returns the part of the next step that is already due
+   * @return Where to draw between the previous (0) and the current step (1)
+   */
+  float getInterpolation() const {return interpolation;}
+
+  /** Drops the accumulated time, so that the real time starts over with the next call of \c getDueSteps */
+  void reset();
+
+private:
+  double accumulator = 0.; /**< The simulated time in s that is due but was not simulated yet */
+  float interpolation = 1.f; /**< The part of the next step that is already due */
+  std::chrono::steady_clock::time_point lastTime; /**< When \c getDueSteps was called the last time */
+  bool started = false; /**< Whether \c getDueSteps was called before */
+};
@@ -0,0 +1,183 @@
+/**
+ * @file TrajectoryLog.cpp
+ * Implementation of classes that write and read logs of simulation states
+ */
+
+#include "TrajectoryLog.h"
+#include "Platform/Assert.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+  constexpr std::uint32_t magic = 0x4c545253; /**< "SRTL" */
+  constexpr std::uint32_t version = 1;
+  constexpr std::streamoff trailerSize = sizeof(std::uint32_t) + sizeof(std::uint64_t) + sizeof(std::uint32_t);
+
+  template<typename T> void writeValue(std::ofstream& stream, const T& value)
+  {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  template<typename T> bool readValue(std::ifstream& stream, T& value)
+  {
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(value)));
+  }
+}
+
+bool TrajectoryLogWriter::open(const std::string& fileName, std::size_t frameSize, unsigned int framesPerChunk)
+{
+  ASSERT(frameSize > 0);
+  ASSERT(framesPerChunk > 0);
+  close();
+  file.open(fileName, std::ios::binary | std::ios::trunc);
+  if(!file.is_open())
+    return false;
+
+  this->frameSize = frameSize;
+  this->framesPerChunk = framesPerChunk;
+  numOfFrames = 0;
+  pendingFrames.clear();
+  pendingFrames.reserve(frameSize * framesPerChunk);
+  previousFrame.assign(frameSize, 0);
+  chunkOffsets.clear();
+
+  writeValue(file, magic);
+  writeValue(file, version);
+  writeValue(file, static_cast<std::uint64_t>(frameSize));
+  writeValue(file, static_cast<std::uint32_t>(framesPerChunk));
+  return static_cast<bool>(file);
+}
+
+void TrajectoryLogWriter::write(const void* frame)
+{
+  ASSERT(isOpen());
+  const char* const data = static_cast<const char*>(frame);
+  if(pendingFrames.empty())
+    pendingFrames.insert(pendingFrames.end(), data, data + frameSize);
+  else
+    for(std::size_t i = 0; i < frameSize; ++i)
+      pendingFrames.push_back(static_cast<char>(data[i] ^ previousFrame[i]));
+  std::memcpy(previousFrame.data(), data, frameSize);
+  ++numOfFrames;
+
+  if(pendingFrames.size() == frameSize * framesPerChunk)
+    writeChunk();
+}
+
+bool TrajectoryLogWriter::close()
+{
+  if(!isOpen())
+    return false;
+  if(!pendingFrames.empty())
+    writeChunk();
+
+  const std::uint64_t indexOffset = static_cast<std::uint64_t>(file.tellp());
+  for(const std::uint64_t offset : chunkOffsets)
+    writeValue(file, offset);
+  writeValue(file, static_cast<std::uint32_t>(numOfFrames));
+  writeValue(file, indexOffset);
+  writeValue(file, magic);
+
+  const bool success = static_cast<bool>(file);
+  file.close();
+  return success;
+}
+
+void TrajectoryLogWriter::writeChunk()
+{
+  // Group the bytes by their position in the frame, so that the unchanged bytes of the XOR encoded frames are adjacent.
+  const std::size_t count = pendingFrames.size() / frameSize;
+  std::vector<char> shuffled(pendingFrames.size());
+  for(std::size_t i = 0; i < count; ++i)
+    for(std::size_t j = 0; j < frameSize; ++j)
+      shuffled[j * count + i] = pendingFrames[i * frameSize + j];
+  pendingFrames.clear();
+
+  codec.compress(shuffled, compressed);
+  chunkOffsets.push_back(static_cast<std::uint64_t>(file.tellp()));
+  writeValue(file, static_cast<std::uint32_t>(compressed.size()));
+  file.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+}
+
+bool TrajectoryLogReader::open(const std::string& fileName)
+{
+  close();
+  file.open(fileName, std::ios::binary);
+  if(!file.is_open())
+    return false;
+
+  std::uint32_t fileMagic = 0, fileVersion = 0, fileFramesPerChunk = 0, fileNumOfFrames = 0, trailerMagic = 0;
+  std::uint64_t fileFrameSize = 0, indexOffset = 0;
+  if(!readValue(file, fileMagic) || !readValue(file, fileVersion) || !readValue(file, fileFrameSize) || !readValue(file, fileFramesPerChunk)
+     || fileMagic != magic || fileVersion != version || !fileFrameSize || !fileFramesPerChunk
+     || !file.seekg(-trailerSize, std::ios::end)
+     || !readValue(file, fileNumOfFrames) || !readValue(file, indexOffset) || !readValue(file, trailerMagic) || trailerMagic != magic
+     || !file.seekg(static_cast<std::streamoff>(indexOffset)))
+  {
+    close();
+    return false;
+  }
+
+  frameSize = static_cast<std::size_t>(fileFrameSize);
+  framesPerChunk = fileFramesPerChunk;
+  numOfFrames = fileNumOfFrames;
+  chunkOffsets.resize((numOfFrames + framesPerChunk - 1) / framesPerChunk);
+  for(std::uint64_t& offset : chunkOffsets)
+    if(!readValue(file, offset))
+    {
+      close();
+      return false;
+    }
+  return true;
+}
+
+void TrajectoryLogReader::close()
+{
+  if(file.is_open())
+    file.close();
+  file.clear();
+  frameSize = 0;
+  framesPerChunk = 0;
+  numOfFrames = 0;
+  chunkOffsets.clear();
+  chunkFrames.clear();
+  currentChunk = 0xffffffff;
+}
+
+bool TrajectoryLogReader::read(unsigned int index, void* frame)
+{
+  if(index >= numOfFrames)
+    return false;
+  const unsigned int chunk = index / framesPerChunk;
+  if(chunk != currentChunk && !readChunk(chunk))
+    return false;
+  std::memcpy(frame, chunkFrames.data() + (index % framesPerChunk) * frameSize, frameSize);
+  return true;
+}
+
+bool TrajectoryLogReader::readChunk(unsigned int chunk)
+{
+  currentChunk = 0xffffffff;
+  std::uint32_t size = 0;
+  file.clear();
+  if(!file.seekg(static_cast<std::streamoff>(chunkOffsets[chunk])) || !readValue(file, size))
+    return false;
+  compressed.resize(size);
+  if(!file.read(compressed.data(), size) || !codec.uncompress(compressed, shuffled))
+    return false;
+  const std::size_t count = std::min(framesPerChunk, numOfFrames - chunk * framesPerChunk);
+  if(shuffled.size() != count * frameSize)
+    return false;
+
+  // Undo the grouping of the bytes and the XOR encoding.
+  chunkFrames.resize(count * frameSize);
+  for(std::size_t i = 0; i < count; ++i)
+    for(std::size_t j = 0; j < frameSize; ++j)
+      chunkFrames[i * frameSize + j] = shuffled[j * count + i];
+  for(std::size_t i = frameSize; i < chunkFrames.size(); ++i)
+    chunkFrames[i] = static_cast<char>(chunkFrames[i] ^ chunkFrames[i - frameSize]);
+
+  currentChunk = chunk;
+  return true;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file TrajectoryLog.h
+ * Declaration of classes that write and read logs of simulation states
+ *
+ * A log stores a sequence of frames of equal size (one per simulation step). The frames are grouped into chunks
+ * that are compressed individually, so that any frame can be read without decompressing the whole log:
+ *
+ * log := header { chunk } index trailer
+ * header := magic version frameSize framesPerChunk
+ * chunk := size compressedFrames
+ * index := { chunkOffset }
+ * trailer := numOfFrames indexOffset magic
+ *
+ * Before compression, each frame except the first one of a chunk is replaced by its XOR with the previous frame and
+ * the bytes are regrouped by their position in the frame. States change little between steps, so this produces
+ * long runs of zeros that compress well.
+ *
+ * This library does not link a compression library, so the functions that compress and decompress the chunks are
+ * passed to the writer and the reader (e.g. \c qtTrajectoryLogCodec from QtTrajectoryLogCodec.h).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @struct TrajectoryLogCodec
+ * The functions that compress and decompress the chunks of a log
+ */
+struct TrajectoryLogCodec
+{
+  /** Fills the second parameter with the compressed first one */
+  std::function<void(const std::vector<char>& data, std::vector<char>& compressed)> compress;
+
+  /** Fills the second parameter with the decompressed first one and returns whether that was possible */
+  std::function<bool(const std::vector<char>& compressed, std::vector<char>& data)> uncompress;
+};
+
+/**
+ * @class TrajectoryLogWriter
+ * Writes frames to a log file
+ */
+class TrajectoryLogWriter
+{
+public:
+  /**
+   * Constructor
+   * @param codec The functions that compress the chunks
+   */
+  explicit TrajectoryLogWriter(const TrajectoryLogCodec& codec) : codec(codec) {}
+
+  /** Destructor. Finishes the log if it is still open. */
+  ~TrajectoryLogWriter() {close();}
+
+  /**
+   * Creates a log file
+   * @param fileName The name of the file
+   * @param frameSize The size of each frame in bytes
+   * @param framesPerChunk The number of frames that are compressed together
+   * @return Whether the file could be created
+   */
+  bool open(const std::string& fileName, std::size_t frameSize, unsigned int framesPerChunk = 256);
+
+  /**
+   * Appends a frame to the log
+   * @param frame The frame (\c frameSize bytes)
+   */
+  void write(const void* frame);
+
+  /**
+   * Writes the pending frames and the index and closes the file
+   * @return Whether the whole log was written successfully
+   */
+  bool close();
+
+  /**
+   * Returns whether a log is being written
+   * @return Whether a log is open
+   */
+  bool isOpen() const {return file.is_open();}
+
+private:
+  /** Compresses the pending frames and writes them as a chunk */
+  void writeChunk();
+
+  TrajectoryLogCodec codec; /**< The functions that compress the chunks */
+  std::ofstream file; /**< The log file */
+  std::size_t frameSize = 0; /**< The size of each frame in bytes */
+  unsigned int framesPerChunk = 0; /**< The number of frames that are compressed together */
+  unsigned int numOfFrames = 0; /**< The number of frames written so far */
+  std::vector<char> pendingFrames; /**< The XOR encoded frames of the current chunk */
+  std::vector<char> previousFrame; /**< The most recent frame */
+  std::vector<char> compressed; /**< Buffer for the compressed chunk */
+  std::vector<std::uint64_t> chunkOffsets; /**< The file offset of each chunk written so far */
+};
+
+/**
+ * @class TrajectoryLogReader
+ * Reads frames from a log file in any order
+ */
+class TrajectoryLogReader
+{
+public:
+  /**
+   * Constructor
+   * @param codec The functions that decompress the chunks
+   */
+  explicit TrajectoryLogReader(const TrajectoryLogCodec& codec) : codec(codec) {}
+
+  /**
+   * Opens a log file and reads its index
+   * @param fileName The name of the file
+   * @return Whether the file is a complete log
+   */
+  bool open(const std::string& fileName);
+
+  /** Closes the log file */
+  void close();
+
+  /**
+   * Returns whether a log is open
+   * @return Whether a log is open
+   */
+  bool isOpen() const {return file.is_open();}
+
+  /**
+   * Returns the size of each frame in the log
+   * @return The size in bytes
+   */
+  std::size_t getFrameSize() const {return frameSize;}
+
+  /**
+   * Returns the number of frames in the log
+   * @return The number of frames
+   */
+  unsigned int getNumOfFrames() const {return numOfFrames;}
+
+  /**
+   * Reads a frame. Reading frames in order only decompresses each chunk once.
+   * @param index The index of the frame
+   * @param frame Is filled with the frame (\c frameSize bytes)
+   * @return Whether the frame could be read
+   */
+  bool read(unsigned int index, void* frame);
+
+private:
+  /**
+   * Reads and decodes a chunk into \c chunkFrames
+   * @param chunk The index of the chunk
+   * @return Whether the chunk could be read
+   */
+  bool readChunk(unsigned int chunk);
+
+  TrajectoryLogCodec codec; /**< The functions that decompress the chunks */
+  std::ifstream file; /**< The log file */
+  std::size_t frameSize = 0; /**< The size of each frame in bytes */
+  unsigned int framesPerChunk = 0; /**< The number of frames that were compressed together */
+  unsigned int numOfFrames = 0; /**< The number of frames in the log */
+  std::vector<std::uint64_t> chunkOffsets; /**< The file offset of each chunk */
+  std::vector<char> compressed; /**< Buffer for the compressed chunk */
+  std::vector<char> shuffled; /**< Buffer for the decompressed chunk before it is decoded */
+  std::vector<char> chunkFrames; /**< The decoded frames of the chunk read last */
+  unsigned int currentChunk = 0xffffffff; /**< The index of the chunk in \c chunkFrames */
+};
@@ -7,6 +7,7 @@
  */
 
 #include "CoreModule.h"
+#include "Platform/Assert.h"
 #include "Simulation/Scene.h"
 #include <QDir>
 #include <QFileInfo>
@@ -30,6 +31,8 @@ CoreModule::CoreModule(SimRobot::Application& application) :
   objectIcon.setIsMask(true);
   CoreModule::application = &application;
   CoreModule::module = this;
+  ASSERT(!simulation);
+  simulation = this;
 }
 
 bool CoreModule::compile()
@@ -135,5 +138,19 @@ bool CoreModule::compile()
 
 void CoreModule::update()
 {
-  doSimulationStep();
+  if(replayer.isOpen())
+  {
+    // Replays only advance through the log without simulating.
+    for(unsigned int steps = getDueSteps(); steps > 0; --steps)
+      doReplayStep();
+    return;
+  }
+
+  for(unsigned int steps = getDueSteps(); steps > 0; --steps)
+    doSimulationStep();
+}
+
+unsigned int CoreModule::getUpdatePeriod() const
+{
+  return scene->realTimeFactor > 0.f ? static_cast<unsigned int>(scene->stepLength / scene->realTimeFactor * 1000000.f) : 0;
 }
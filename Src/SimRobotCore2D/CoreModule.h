@@ -36,4 +36,10 @@ private:
 
   /** Advances the simulation by one step. */
   void update() override;
+
+  /**
+   * Returns how often \c update should be called, i.e. once per step if the scene runs in real time.
+   * @return The time between two updates in microseconds or 0 if updates should happen as often as possible.
+   */
+  [[nodiscard]] unsigned int getUpdatePeriod() const override;
 };
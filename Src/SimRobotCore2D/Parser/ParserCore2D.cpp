@@ -23,6 +23,8 @@
 #include "Simulation/Masses/PointMass.h"
 #include "Simulation/Masses/RectMass.h"
 #include "Simulation/Scene.h"
+#include "Simulation/Sensors/FieldOfViewSensor.h"
+#include "Simulation/Sensors/LaserSensor.h"
 #include "Simulation/Simulation.h"
 #include "Tools/Math/Constants.h"
 #include <box2d/b2_math.h>
@@ -43,7 +45,7 @@ ParserCore2D::ParserCore2D()
 
     {"Scene", sceneClass, std::bind(&ParserCore2D::sceneElement, this), nullptr, 0, 0, 0, setClass | bodyClass | compoundClass, {"background"}},
 
-    {"Body", bodyClass, std::bind(&ParserCore2D::bodyElement, this), nullptr, 0, massClass, translationClass | rotationClass, setClass | massClass | geometryClass, {}},
+    {"Body", bodyClass, std::bind(&ParserCore2D::bodyElement, this), nullptr, 0, massClass, translationClass | rotationClass, setClass | massClass | geometryClass | sensorClass, {}},
 
     {"Compound", compoundClass, std::bind(&ParserCore2D::compoundElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass | bodyClass | compoundClass | geometryClass, {}},
 
@@ -61,7 +63,10 @@ ParserCore2D::ParserCore2D()
     {"ConvexGeometry", geometryClass, std::bind(&ParserCore2D::convexGeometryElement, this), std::bind(&ParserCore2D::verticesText, this, _1, _2), textFlag, 0, translationClass | rotationClass, setClass | geometryClass, {}},
     {"DiskGeometry", geometryClass, std::bind(&ParserCore2D::diskGeometryElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass | geometryClass, {}},
     {"EdgeGeometry", geometryClass, std::bind(&ParserCore2D::edgeGeometryElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass | geometryClass, {}},
-    {"RectGeometry", geometryClass, std::bind(&ParserCore2D::rectGeometryElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass | geometryClass, {}}
+    {"RectGeometry", geometryClass, std::bind(&ParserCore2D::rectGeometryElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass | geometryClass, {}},
+
+    {"LaserSensor", sensorClass, std::bind(&ParserCore2D::laserSensorElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass, {}},
+    {"FieldOfViewSensor", sensorClass, std::bind(&ParserCore2D::fieldOfViewSensorElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass, {}}
   };
 
   for(const ElementInfo& element : elements)
@@ -99,6 +104,8 @@ Element* ParserCore2D::sceneElement()
   scene->stepLength = getTimeNonZeroPositive("stepLength", false, 0.01f);
   scene->velocityIterations = getInteger("velocityIterations", false, 8, true);
   scene->positionIterations = getInteger("positionIterations", false, 3, true);
+  scene->realTimeFactor = getFloatPositive("realTimeFactor", false, 0.f);
+  scene->maxSubSteps = static_cast<unsigned int>(getInteger("maxSubSteps", false, 10, true));
   scene->background = getString("background", false);
 
   ASSERT(!Simulation::simulation->scene);
@@ -242,6 +249,28 @@ Element* ParserCore2D::rectGeometryElement()
   return rectGeometry;
 }
 
+Element* ParserCore2D::laserSensorElement()
+{
+  auto* const laserSensor = new LaserSensor;
+  laserSensor->name = getString("name", false);
+  laserSensor->mask = getUInt16("mask", false, 0xffff);
+  laserSensor->range = getLength("range", true, 0.f, true);
+  laserSensor->openingAngle = getAngle("openingAngle", false, 0.f, false);
+  laserSensor->rays = getInteger("rays", false, 1, true);
+  return laserSensor;
+}
+
+Element* ParserCore2D::fieldOfViewSensorElement()
+{
+  auto* const fieldOfViewSensor = new FieldOfViewSensor;
+  fieldOfViewSensor->name = getString("name", false);
+  fieldOfViewSensor->mask = getUInt16("mask", false, 0xffff);
+  fieldOfViewSensor->range = getLength("range", true, 0.f, true);
+  fieldOfViewSensor->openingAngle = getAngle("openingAngle", true, 0.f, true);
+  fieldOfViewSensor->occlusion = getBool("occlusion", false, true);
+  return fieldOfViewSensor;
+}
+
 void ParserCore2D::verticesText(std::string& text, Reader::Location location)
 {
   std::vector<b2Vec2>* vertices;
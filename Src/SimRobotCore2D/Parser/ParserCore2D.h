@@ -32,7 +32,8 @@ private:
     translationClass = (1u << 4u),
     rotationClass    = (1u << 5u),
     massClass        = (1u << 6u),
-    geometryClass    = (1u << 7u)
+    geometryClass    = (1u << 7u),
+    sensorClass      = (1u << 8u)
   };
 
   bool getColor(const char* key, bool required, QColor& color);
@@ -53,6 +54,8 @@ private:
   Element* diskGeometryElement();
   Element* edgeGeometryElement();
   Element* rectGeometryElement();
+  Element* laserSensorElement();
+  Element* fieldOfViewSensorElement();
   void verticesText(std::string& text, Location location);
 
   std::vector<ElementInfo> elements;
@@ -25,6 +25,35 @@ SimObjectPainter::SimObjectPainter(SimObject& simObject) :
 
 void SimObjectPainter::draw(QPaintDevice* device)
 {
+  draw(device, QRegion(QRect(QPoint(), size)));
+}
+
+void SimObjectPainter::draw(QPaintDevice* device, const QRegion& region)
+{
+  if(&simObject == Simulation::simulation->scene)
+  {
+    // The background and the compounds only change with the view, so they are rasterized once and blitted afterwards.
+    const qreal devicePixelRatio = device->devicePixelRatioF();
+    if(!staticLayerValid || staticLayer.devicePixelRatio() != devicePixelRatio)
+      updateStaticLayer(devicePixelRatio);
+    // The bodies are only recorded anew by updateDynamicLayer, because only then the area they covered before is repainted.
+    if(!dynamicLayerValid)
+      recordDynamicLayer();
+
+    painter.begin(device);
+    ASSERT(painter.window().size() == size);
+    for(const QRect& rect : region)
+      painter.drawPixmap(rect, staticLayer, QRectF(QPointF(rect.topLeft()) * devicePixelRatio, QSizeF(rect.size()) * devicePixelRatio));
+
+    // Only the bodies that overlap the repainted region are replayed.
+    for(const BodyDrawing& drawing : dynamicLayer)
+      if(region.intersects(drawing.bounds))
+        painter.drawPicture(0, 0, drawing.picture);
+
+    painter.end();
+    return;
+  }
+
   painter.begin(device);
 
   ASSERT(painter.window().size() == size);
@@ -34,7 +63,7 @@ void SimObjectPainter::draw(QPaintDevice* device)
 
   if(physicalObject)
   {
-    Simulation::simulation->scene->updateTransformations();
+    Simulation::simulation->scene->updateTransformations(Simulation::simulation->renderInterpolation);
 
     painter.setTransform(physicalObject->transformation.inverted(nullptr), true);
     physicalObject->drawPhysics(painter);
@@ -43,6 +72,18 @@ void SimObjectPainter::draw(QPaintDevice* device)
   painter.end();
 }
 
+bool SimObjectPainter::updateDynamicLayer(QRegion& region)
+{
+  if(&simObject != Simulation::simulation->scene)
+    return false;
+
+  // The areas covered before must be repainted as well to remove the bodies from there.
+  region = dynamicRegion;
+  recordDynamicLayer();
+  region += dynamicRegion;
+  return staticLayerValid;
+}
+
 void SimObjectPainter::zoom(float change, int x, int y)
 {
   const b2Vec2 beforeZoom = (x >= 0 && y >= 0) ? windowToWorld(QPointF(x, y)) : b2Vec2_zero;
@@ -289,4 +330,44 @@ void SimObjectPainter::updateTransform()
   transform.rotateRadians(rotation);
   transform.translate(offset.x, offset.y);
   transformInv = transform.inverted(nullptr);
+  staticLayerValid = false;
+  dynamicLayerValid = false;
+}
+
+void SimObjectPainter::updateStaticLayer(qreal devicePixelRatio)
+{
+  staticLayer = QPixmap(size * devicePixelRatio);
+  staticLayer.setDevicePixelRatio(devicePixelRatio);
+  staticLayer.fill(Qt::transparent);
+
+  QPainter layerPainter(&staticLayer);
+  layerPainter.setTransform(transform);
+  Simulation::simulation->scene->drawStaticPhysics(layerPainter);
+  layerPainter.end();
+
+  staticLayerValid = true;
+}
+
+void SimObjectPainter::recordDynamicLayer()
+{
+  Simulation::simulation->scene->updateTransformations(Simulation::simulation->renderInterpolation);
+
+  const QRect window(QPoint(), size);
+  dynamicLayer.resize(Simulation::simulation->scene->bodies.size());
+  dynamicRegion = QRegion();
+  auto drawing = dynamicLayer.begin();
+  for(const Body* body : Simulation::simulation->scene->bodies)
+  {
+    drawing->picture = QPicture();
+    QPainter recorder(&drawing->picture);
+    recorder.setTransform(transform);
+    body->drawPhysics(recorder);
+    recorder.end();
+
+    // The bounding rectangle ignores thin pens and antialiasing, so a small margin is added.
+    drawing->bounds = drawing->picture.boundingRect().adjusted(-2, -2, 2, 2) & window;
+    dynamicRegion += drawing->bounds;
+    ++drawing;
+  }
+  dynamicLayerValid = true;
 }
@@ -11,7 +11,11 @@
 #include "SimRobotCore2D.h"
 #include <box2d/b2_math.h>
 #include <QPainter>
+#include <QPicture>
+#include <QPixmap>
 #include <QPointF>
+#include <QRegion>
+#include <vector>
 
 class Body;
 class SimObject;
@@ -31,6 +35,21 @@ public:
    */
   void draw(QPaintDevice* device) override;
 
+  /**
+   * Draws the part of the object that lies in a region to a device.
+   * @param device The device to which to draw.
+   * @param region The region of the device that has to be drawn.
+   */
+  void draw(QPaintDevice* device, const QRegion& region);
+
+  /**
+   * Records the bodies of the scene in their current poses and determines which part of the device
+   * must be repainted to show them.
+   * @param region Is set to the area covered by the bodies before and after this call.
+   * @return Whether repainting \c region suffices. Otherwise, the whole device must be repainted.
+   */
+  bool updateDynamicLayer(QRegion& region);
+
   /**
    * Changes the zoom of the painter.
    * @param change The change in zoom.
@@ -133,6 +152,22 @@ private:
   /** Updates the transformation matrices derived from \c size, \c offset, \c zoomFactor and \c rotation. */
   void updateTransform();
 
+  /**
+   * Rasterizes the static parts of the scene (background and compounds) into \c staticLayer.
+   * @param devicePixelRatio The device pixel ratio of the device the layer is drawn to.
+   */
+  void updateStaticLayer(qreal devicePixelRatio);
+
+  /** Records the drawings of each body of the scene into \c dynamicLayer and updates \c dynamicRegion. */
+  void recordDynamicLayer();
+
+  /** The drawings of a body of the scene. */
+  struct BodyDrawing
+  {
+    QPicture picture; /**< The drawings in window coordinates. */
+    QRect bounds; /**< The area of the window covered by the drawings. */
+  };
+
   SimObject& simObject; /**< The object to paint. */
   QPainter painter; /**< The Qt painter. */
 
@@ -150,4 +185,11 @@ private:
 
   QTransform transform; /**< Transforms world coordinates into window coordinates. */
   QTransform transformInv; /**< Transforms window coordinates into world coordinates. */
+
+  QPixmap staticLayer; /**< The static parts of the scene as they look with the current transformation. */
+  bool staticLayerValid = false; /**< Whether \c staticLayer matches the current transformation. */
+
+  std::vector<BodyDrawing> dynamicLayer; /**< The bodies of the scene as recorded last. */
+  QRegion dynamicRegion; /**< The area of the window covered by \c dynamicLayer. */
+  bool dynamicLayerValid = false; /**< Whether \c dynamicLayer was recorded with the current transformation. */
 };
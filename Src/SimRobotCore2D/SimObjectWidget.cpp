@@ -58,7 +58,11 @@ QWidget* SimObjectWidget::getWidget()
 
 void SimObjectWidget::update()
 {
-  QWidget::update();
+  QRegion region;
+  if(objectPainter.updateDynamicLayer(region))
+    QWidget::update(region);
+  else
+    QWidget::update();
 }
 
 QMenu* SimObjectWidget::createUserMenu() const
@@ -106,7 +110,7 @@ QMenu* SimObjectWidget::createUserMenu() const
 void SimObjectWidget::paintEvent(QPaintEvent* event)
 {
   QWidget::paintEvent(event);
-  objectPainter.draw(this);
+  objectPainter.draw(this, event->region());
 }
 
 void SimObjectWidget::mouseDoubleClickEvent(QMouseEvent* event)
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "SimRobot.h"
+#include <QList>
 
 class QPaintDevice;
 
@@ -24,7 +25,8 @@ namespace SimRobotCore2D
     body, /**< An object of the type SimRobotCore2D::Body. */
     compound, /**< An object of the type SimRobotCore2D::Compound. */
     mass, /**< An object of the type SimRobotCore2D::Mass. */
-    geometry /**< An object of the type SimRobotCore2D::Geometry. */
+    geometry, /**< An object of the type SimRobotCore2D::Geometry. */
+    sensorPort /**< An object of the type SimRobotCore2D::SensorPort. */
   };
 
   class Object : public SimRobot::Object
@@ -82,6 +84,75 @@ namespace SimRobotCore2D
      * @return The frame rate in frames per second.
      */
     [[nodiscard]] virtual unsigned int getFrameRate() const = 0;
+
+    /**
+     * Finds the root bodies which have a geometry that overlaps an axis-aligned box.
+     * @param min The minimum corner of the box.
+     * @param max The maximum corner of the box.
+     * @param bodies Is filled with the root bodies found.
+     */
+    virtual void queryAABB(const float* min, const float* max, QList<Body*>& bodies) const = 0;
+
+    /**
+     * Finds the root bodies whose positions are within a circle. Only bodies with geometries are found.
+     * @param center The center of the circle.
+     * @param radius The radius of the circle.
+     * @param bodies Is filled with the root bodies found.
+     */
+    virtual void queryRadius(const float* center, float radius, QList<Body*>& bodies) const = 0;
+
+    /**
+     * Finds the root bodies whose positions are closest to a point. Only bodies with geometries are found.
+     * @param point The point.
+     * @param count The maximum number of bodies to find.
+     * @param bodies Is filled with the root bodies found, sorted by increasing distance.
+     */
+    virtual void queryNearest(const float* point, unsigned int count, QList<Body*>& bodies) const = 0;
+
+    /**
+     * Finds the first geometry that is hit by a ray.
+     * @param origin The start of the ray.
+     * @param direction The direction of the ray (does not need to be normalized).
+     * @param maxDistance The maximum length of the ray.
+     * @param distance Is set to the distance to the hit, if not nullptr and something was hit.
+     * @return The root body that was hit or nullptr if nothing or a compound was hit.
+     */
+    virtual Body* queryRay(const float* origin, const float* direction, float maxDistance, float* distance = nullptr) const = 0;
+
+    /**
+     * Starts writing the state after each simulation step to a compressed log, beginning with the current state.
+     * The log contains the pose and velocity of all bodies.
+     * @param fileName The name of the log file.
+     * @return Whether the file could be created.
+     */
+    virtual bool startRecording(const QString& fileName) = 0;
+
+    /** Stops writing the log and completes the file. */
+    virtual void stopRecording() = 0;
+
+    /**
+     * Starts replaying a log recorded from this scene. Instead of simulating, each step then advances to the
+     * next state in the log. Sensors compute their readings from the replayed poses.
+     * @param fileName The name of the log file.
+     * @return Whether the file is a log of a scene with the same number of bodies.
+     */
+    virtual bool startReplay(const QString& fileName) = 0;
+
+    /** Stops replaying, i.e. the simulation continues from the state replayed last. */
+    virtual void stopReplay() = 0;
+
+    /**
+     * Jumps to a state in the replayed log.
+     * @param frame The index of the state in the log.
+     * @return Whether a log is replayed and contains the state.
+     */
+    virtual bool seekReplay(unsigned int frame) = 0;
+
+    /**
+     * Returns the number of states in the replayed log.
+     * @return The number of states or 0 if no log is replayed.
+     */
+    [[nodiscard]] virtual unsigned int getReplayLength() const = 0;
   };
 
   class Body : public PhysicalObject
@@ -216,6 +287,52 @@ namespace SimRobotCore2D
     virtual bool unregisterCollisionCallback(CollisionCallback& callback) = 0;
   };
 
+  class SensorPort : public Object
+  {
+  public:
+    enum SensorType
+    {
+      distanceSensor, /**< A sensor that measures distances along rays (see \c getDistances). */
+      visibilitySensor /**< A sensor that determines which bodies are visible (see \c getVisibleBodies). */
+    };
+
+    /**
+     * Returns an object type identifier.
+     * @return The identifier.
+     */
+    [[nodiscard]] int getKind() const override
+    {
+      return sensorPort;
+    }
+
+    /**
+     * Returns the type of the sensor readings.
+     * @return The type.
+     */
+    [[nodiscard]] virtual SensorType getSensorType() const = 0;
+
+    /**
+     * Returns the maximum distance the sensor can measure or see.
+     * @return The range (in m).
+     */
+    [[nodiscard]] virtual float getRange() const = 0;
+
+    /**
+     * Returns the distances measured by a distance sensor in the most recent simulation step.
+     * Rays that did not hit anything measure the range of the sensor.
+     * @param count Is set to the number of distances (which is 0 for other sensor types).
+     * @return The distances (in m), ordered from the rightmost to the leftmost ray.
+     */
+    [[nodiscard]] virtual const float* getDistances(unsigned int& count) const = 0;
+
+    /**
+     * Returns the bodies a visibility sensor saw in the most recent simulation step.
+     * @param count Is set to the number of bodies (which is 0 for other sensor types).
+     * @return The root bodies that are visible.
+     */
+    [[nodiscard]] virtual Body* const* getVisibleBodies(unsigned int& count) const = 0;
+  };
+
   class Painter
   {
   public:
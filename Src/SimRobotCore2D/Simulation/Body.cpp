@@ -48,6 +48,8 @@ void Body::createPhysics()
   bodyDef.angle = pose.q.GetAngle();
   reinterpret_cast<Body*&>(bodyDef.userData.pointer) = this;
   body = Simulation::simulation->world->CreateBody(&bodyDef);
+  previousPosition = bodyDef.position;
+  previousAngle = bodyDef.angle;
 
   // Add geometries.
   b2Transform geometryPose;
@@ -92,12 +94,16 @@ void Body::drawPhysics(QPainter& painter) const
     child->drawPhysics(painter);
 }
 
-void Body::updateTransformation()
+void Body::updateTransformation(float interpolation)
 {
-  // Get the transformation from Box2D and traverse children.
-  QtTools::convertTransformation(body->GetAngle(), body->GetPosition(), transformation);
+  // Get the transformation from Box2D (possibly blended with the one of the previous step) and traverse children.
+  if(interpolation < 1.f)
+    QtTools::convertTransformation(previousAngle + interpolation * normalize(body->GetAngle() - previousAngle),
+                                   previousPosition + interpolation * (body->GetPosition() - previousPosition), transformation);
+  else
+    QtTools::convertTransformation(body->GetAngle(), body->GetPosition(), transformation);
   for(Body* child : bodyChildren)
-    child->updateTransformation();
+    child->updateTransformation(interpolation);
 }
 
 void Body::addParent(Element& element)
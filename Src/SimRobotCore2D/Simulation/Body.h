@@ -25,11 +25,16 @@ public:
    */
   void drawPhysics(QPainter& painter) const override;
 
-  /** Updates the transformation of the body. */
-  void updateTransformation();
+  /**
+   * Updates the transformation of the body.
+   * @param interpolation Where to place the body between the previous (0) and the current step (1).
+   */
+  void updateTransformation(float interpolation = 1.f);
 
   Body* rootBody = nullptr; /**< The ancestor body which is a direct child of the scene element. */
   b2Body* body = nullptr; /**< The Box2D body object. */
+  b2Vec2 previousPosition; /**< The position of the body before the most recent step (only updated if the scene runs in real time). */
+  float previousAngle = 0.f; /**< The rotation of the body before the most recent step (only updated if the scene runs in real time). */
 
 protected:
   /** Initializes the physical properties of the body. */
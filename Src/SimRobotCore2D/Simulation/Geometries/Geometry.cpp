@@ -9,6 +9,7 @@
 #include "Geometry.h"
 #include "Platform/Assert.h"
 #include "Simulation/Body.h"
+#include "Simulation/Simulation.h"
 #include "Tools/QtTools.h"
 #include <box2d/b2_shape.h>
 #include <box2d/b2_body.h>
@@ -89,6 +90,8 @@ SimRobotCore2D::Body* Geometry::getParentBody() const
 void Geometry::registerCollisionCallback(SimRobotCore2D::CollisionCallback& callback)
 {
   callbacks.push_back(&callback);
+  if(callbacks.size() == 1)
+    Simulation::simulation->trackContacts(*this);
 }
 
 bool Geometry::unregisterCollisionCallback(SimRobotCore2D::CollisionCallback& callback)
@@ -97,6 +100,8 @@ bool Geometry::unregisterCollisionCallback(SimRobotCore2D::CollisionCallback& ca
     if(*it == &callback)
     {
       callbacks.erase(it);
+      if(callbacks.empty())
+        Simulation::simulation->untrackContacts(*this);
       return true;
     }
   return false;
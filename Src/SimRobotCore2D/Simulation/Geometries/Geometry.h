@@ -11,8 +11,10 @@
 #include "Simulation/PhysicalObject.h"
 #include "SimRobotCore2D.h"
 #include <list>
+#include <vector>
 
 class b2Body;
+class b2Contact;
 class b2Fixture;
 class b2Shape;
 class QPainter;
@@ -20,6 +22,14 @@ class QPainter;
 class Geometry : public PhysicalObject, public SimRobotCore2D::Geometry
 {
 public:
+  /** A touching contact of this geometry. */
+  struct Contact
+  {
+    b2Contact* contact; /**< The Box2D contact. */
+    Geometry* other; /**< The other geometry of the contact. */
+    bool isNew; /**< Whether the contact began in the current step (and was therefore already reported). */
+  };
+
   /**
    * Adds the geometry to a body.
    * @param body The Box2D body to which the geometry should be attached.
@@ -28,6 +38,8 @@ public:
   void createGeometry(b2Body* body, const b2Transform& geometryPose);
 
   std::list<SimRobotCore2D::CollisionCallback*> callbacks; /**< The list of collision callbacks registered for this geometry. */
+  std::vector<Contact> contacts; /**< The touching contacts of this geometry (only tracked while there are callbacks). */
+  std::size_t callbackIndex = 0; /**< The index of this geometry in \c Simulation::geometriesWithCallbacks (only valid while there are callbacks). */
   std::uint16_t category = 0; /**< The category for collision filtering (0-15). */
   std::uint16_t mask = 0xffff; /**< The mask of categories with which this geometry wants to collide. */
 
@@ -99,6 +111,8 @@ protected:
 
 private:
   b2Fixture* fixture = nullptr; /**< The Box2D fixture that this object represents. */
+
+  friend class Simulation;
 };
 
 inline b2Shape* Geometry::createShape(const b2Transform&) {return nullptr;}
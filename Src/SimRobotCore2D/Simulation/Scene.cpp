@@ -10,7 +10,12 @@
 #include "Simulation/Body.h"
 #include "Simulation/Simulation.h"
 #include "CoreModule.h"
+#include <box2d/b2_body.h>
+#include <box2d/b2_fixture.h>
+#include <box2d/b2_world.h>
 #include <QPainter>
+#include <algorithm>
+#include <utility>
 
 void Scene::createPhysics()
 {
@@ -20,26 +25,31 @@ void Scene::createPhysics()
 }
 
 void Scene::drawPhysics(QPainter& painter) const
+{
+  drawStaticPhysics(painter);
+  drawDynamicPhysics(painter);
+}
+
+void Scene::drawStaticPhysics(QPainter& painter) const
 {
   if(!background.empty())
   {
-    painter.save();
     const QRectF viewBox = backgroundRenderer.viewBoxF();
-    painter.setTransform(QTransform::fromTranslate(-viewBox.width() / 2, -viewBox.height() / 2).
-                         scale(viewBox.width() / painter.device()->width(), viewBox.height() / painter.device()->height()),
-                         true);
-    backgroundRenderer.render(&painter);
-    painter.restore();
+    backgroundRenderer.render(&painter, QRectF(-viewBox.width() / 2, -viewBox.height() / 2, viewBox.width(), viewBox.height()));
   }
+  ::PhysicalObject::drawPhysics(painter);
+}
+
+void Scene::drawDynamicPhysics(QPainter& painter) const
+{
   for(const Body* body : bodies)
     body->drawPhysics(painter);
-  ::PhysicalObject::drawPhysics(painter);
 }
 
-void Scene::updateTransformations()
+void Scene::updateTransformations(float interpolation)
 {
   for(Body* body : bodies)
-    body->updateTransformation();
+    body->updateTransformation(interpolation);
 }
 
 const QString& Scene::getFullName() const
@@ -86,3 +96,156 @@ unsigned int Scene::getFrameRate() const
 {
   return Simulation::simulation->currentFrameRate;
 }
+
+void Scene::collectBodies(const b2AABB& box, bool exact) const
+{
+  class Callback : public b2QueryCallback
+  {
+  public:
+    Callback(std::vector<Body*>& bodies, const b2AABB& box, bool exact) :
+      bodies(bodies), box(box), exact(exact)
+    {}
+
+  private:
+    bool ReportFixture(b2Fixture* fixture) override
+    {
+      b2Body* const body = fixture->GetBody();
+      if(body == Simulation::simulation->staticBody)
+        return true;
+      if(exact)
+      {
+        bool overlaps = false;
+        for(int i = 0, count = fixture->GetShape()->GetChildCount(); i < count && !overlaps; ++i)
+          overlaps = b2TestOverlap(fixture->GetAABB(i), box);
+        if(!overlaps)
+          return true;
+      }
+      Body* const rootBody = reinterpret_cast<Body*>(body->GetUserData().pointer)->rootBody;
+      if(std::find(bodies.begin(), bodies.end(), rootBody) == bodies.end())
+        bodies.push_back(rootBody);
+      return true;
+    }
+
+    std::vector<Body*>& bodies; /**< The root bodies found so far. */
+    b2AABB box; /**< The box that is queried. */
+    bool exact; /**< Whether to check the bounding boxes of the fixtures. */
+  };
+
+  queryCandidates.clear();
+  Callback callback(queryCandidates, box, exact);
+  Simulation::simulation->world->QueryAABB(&callback, box);
+}
+
+void Scene::queryAABB(const float* min, const float* max, QList<SimRobotCore2D::Body*>& bodies) const
+{
+  b2AABB box;
+  box.lowerBound = b2Vec2(min[0], min[1]);
+  box.upperBound = b2Vec2(max[0], max[1]);
+  collectBodies(box, true);
+  bodies.clear();
+  for(Body* body : queryCandidates)
+    bodies.append(body);
+}
+
+void Scene::queryRadius(const float* center, float radius, QList<SimRobotCore2D::Body*>& bodies) const
+{
+  const b2Vec2 queryCenter(center[0], center[1]);
+  b2AABB box;
+  box.lowerBound = queryCenter - b2Vec2(radius, radius);
+  box.upperBound = queryCenter + b2Vec2(radius, radius);
+  collectBodies(box, false);
+  bodies.clear();
+  for(Body* body : queryCandidates)
+    if(b2DistanceSquared(body->body->GetPosition(), queryCenter) <= radius * radius)
+      bodies.append(body);
+}
+
+void Scene::queryNearest(const float* point, unsigned int count, QList<SimRobotCore2D::Body*>& bodies) const
+{
+  bodies.clear();
+  if(!count)
+    return;
+
+  // Grow the query box until it contains enough bodies. The nearest bodies are then among those whose distance is within the radius.
+  const b2Vec2 queryPoint(point[0], point[1]);
+  std::vector<std::pair<float, Body*>> candidates;
+  for(float radius = 1.f;; radius *= 2.f)
+  {
+    b2AABB box;
+    box.lowerBound = queryPoint - b2Vec2(radius, radius);
+    box.upperBound = queryPoint + b2Vec2(radius, radius);
+    collectBodies(box, false);
+    candidates.clear();
+    for(Body* body : queryCandidates)
+      candidates.emplace_back(b2DistanceSquared(body->body->GetPosition(), queryPoint), body);
+    const auto withinRadius = std::count_if(candidates.begin(), candidates.end(), [radius](const auto& candidate) {return candidate.first <= radius * radius;});
+    if(static_cast<std::size_t>(withinRadius) >= count || queryCandidates.size() >= this->bodies.size() || radius > 65536.f)
+      break;
+  }
+
+  const auto end = candidates.begin() + std::min(static_cast<std::size_t>(count), candidates.size());
+  std::partial_sort(candidates.begin(), end, candidates.end(), [](const auto& a, const auto& b) {return a.first < b.first;});
+  for(auto candidate = candidates.begin(); candidate != end; ++candidate)
+    bodies.append(candidate->second);
+}
+
+SimRobotCore2D::Body* Scene::queryRay(const float* origin, const float* direction, float maxDistance, float* distance) const
+{
+  class Callback : public b2RayCastCallback
+  {
+  public:
+    b2Fixture* closest = nullptr; /**< The closest fixture on the ray. */
+    float fraction = 1.f; /**< The fraction of the ray at which \c closest was hit. */
+
+  private:
+    float ReportFixture(b2Fixture* fixture, const b2Vec2&, const b2Vec2&, float fraction) override
+    {
+      closest = fixture;
+      this->fraction = fraction;
+      return fraction;
+    }
+  };
+
+  b2Vec2 queryDirection(direction[0], direction[1]);
+  if(queryDirection.Normalize() == 0.f || maxDistance <= 0.f)
+    return nullptr;
+  const b2Vec2 start(origin[0], origin[1]);
+  Callback callback;
+  Simulation::simulation->world->RayCast(&callback, start, start + maxDistance * queryDirection);
+  if(!callback.closest)
+    return nullptr;
+  if(distance)
+    *distance = callback.fraction * maxDistance;
+  b2Body* const body = callback.closest->GetBody();
+  return body == Simulation::simulation->staticBody ? nullptr : reinterpret_cast<Body*>(body->GetUserData().pointer)->rootBody;
+}
+
+bool Scene::startRecording(const QString& fileName)
+{
+  return Simulation::simulation->startRecording(fileName.toStdString());
+}
+
+void Scene::stopRecording()
+{
+  Simulation::simulation->stopRecording();
+}
+
+bool Scene::startReplay(const QString& fileName)
+{
+  return Simulation::simulation->startReplay(fileName.toStdString());
+}
+
+void Scene::stopReplay()
+{
+  Simulation::simulation->stopReplay();
+}
+
+bool Scene::seekReplay(unsigned int frame)
+{
+  return Simulation::simulation->replayer.isOpen() && Simulation::simulation->seekReplay(frame);
+}
+
+unsigned int Scene::getReplayLength() const
+{
+  return Simulation::simulation->replayer.getNumOfFrames();
+}
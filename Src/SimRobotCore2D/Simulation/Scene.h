@@ -11,8 +11,10 @@
 #include "Simulation/PhysicalObject.h"
 #include "SimRobotCore2D.h"
 #include <QSvgRenderer>
+#include <box2d/b2_collision.h>
 #include <list>
 #include <string>
+#include <vector>
 
 class Body;
 
@@ -28,13 +30,30 @@ public:
    */
   void drawPhysics(QPainter& painter) const override;
 
-  /** Updates the transformations of all bodies. */
-  void updateTransformations();
+  /**
+   * Draws the parts of the scene that never move, i.e. the background image and all compounds.
+   * @param painter The drawing helper.
+   */
+  void drawStaticPhysics(QPainter& painter) const;
+
+  /**
+   * Draws the bodies of the scene.
+   * @param painter The drawing helper.
+   */
+  void drawDynamicPhysics(QPainter& painter) const;
+
+  /**
+   * Updates the transformations of all bodies.
+   * @param interpolation Where to place the bodies between the previous (0) and the current step (1).
+   */
+  void updateTransformations(float interpolation = 1.f);
 
   std::string controller; /**< The name of the controller library for the scene. */
   float stepLength = 0.01f; /**< The duration of a simulation step [s]. */
   int velocityIterations = 8; /**< The number of Box2D iterations for solving the velocities. */
   int positionIterations = 3; /**< The number of Box2D iterations for solving the positions. */
+  float realTimeFactor = 0.f; /**< How fast the simulated time advances relative to the real time (0 means one step per update). */
+  unsigned int maxSubSteps = 10; /**< The maximum number of steps per update if the simulation runs in real time. */
   std::string background; /**< An optional background image that is drawn behind the physics. */
   std::list<Body*> bodies; /**< All bodies without a parent in the scene. */
 
@@ -50,6 +69,26 @@ protected:
   [[nodiscard]] double getTime() const override;
   [[nodiscard]] unsigned int getFrameRate() const override;
 
+  void queryAABB(const float* min, const float* max, QList<SimRobotCore2D::Body*>& bodies) const override;
+  void queryRadius(const float* center, float radius, QList<SimRobotCore2D::Body*>& bodies) const override;
+  void queryNearest(const float* point, unsigned int count, QList<SimRobotCore2D::Body*>& bodies) const override;
+  SimRobotCore2D::Body* queryRay(const float* origin, const float* direction, float maxDistance, float* distance) const override;
+
+  bool startRecording(const QString& fileName) override;
+  void stopRecording() override;
+  bool startReplay(const QString& fileName) override;
+  void stopReplay() override;
+  bool seekReplay(unsigned int frame) override;
+  [[nodiscard]] unsigned int getReplayLength() const override;
+
 private:
+  /**
+   * Collects the root bodies which have a fixture whose bounding box overlaps a box, using the Box2D broadphase.
+   * @param box The box in world coordinates.
+   * @param exact Whether to check the bounding boxes of the fixtures instead of the (enlarged) ones in the broadphase.
+   */
+  void collectBodies(const b2AABB& box, bool exact) const;
+
+  mutable std::vector<Body*> queryCandidates; /**< The bodies found by \c collectBodies (reused to avoid allocations). */
   mutable QSvgRenderer backgroundRenderer; /**< The renderer for the background image. */
 };
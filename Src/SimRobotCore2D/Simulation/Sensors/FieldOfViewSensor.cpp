@@ -0,0 +1,123 @@
+/**
+ * @file FieldOfViewSensor.cpp
+ *
+ * This file implements a sensor that determines which bodies are within its field of view.
+ */
+
+#include "FieldOfViewSensor.h"
+#include "Simulation/Body.h"
+#include "Simulation/Simulation.h"
+#include <box2d/b2_body.h>
+#include <box2d/b2_collision.h>
+#include <box2d/b2_fixture.h>
+#include <box2d/b2_world.h>
+#include <QPainter>
+#include <QPolygonF>
+#include <algorithm>
+#include <cmath>
+
+void FieldOfViewSensor::updateValue()
+{
+  const b2Transform pose = getWorldPose();
+
+  // Collect the bodies that have a perceivable fixture within the range.
+  class Callback : public b2QueryCallback
+  {
+  public:
+    explicit Callback(FieldOfViewSensor& sensor) :
+      sensor(sensor)
+    {}
+
+  private:
+    bool ReportFixture(b2Fixture* fixture) override
+    {
+      if(sensor.perceives(fixture))
+        if(Body* const body = getRootBody(fixture); body && std::find(sensor.candidates.begin(), sensor.candidates.end(), body) == sensor.candidates.end())
+          sensor.candidates.push_back(body);
+      return true;
+    }
+
+    FieldOfViewSensor& sensor; /**< The sensor that collects the candidates. */
+  };
+
+  candidates.clear();
+  Callback callback(*this);
+  b2AABB boundingBox;
+  boundingBox.lowerBound = pose.p - b2Vec2(range, range);
+  boundingBox.upperBound = pose.p + b2Vec2(range, range);
+  Simulation::simulation->world->QueryAABB(&callback, boundingBox);
+
+  // Check the position of each candidate against the field of view and the line of sight.
+  visibleBodies.clear();
+  for(Body* body : candidates)
+  {
+    const b2Vec2 target = body->body->GetPosition();
+    const b2Vec2 offsetToTarget = b2MulT(pose.q, target - pose.p);
+    if(offsetToTarget.LengthSquared() > range * range
+       || std::abs(std::atan2(offsetToTarget.y, offsetToTarget.x)) > openingAngle * 0.5f
+       || (occlusion && !isInLineOfSight(pose.p, target, body)))
+      continue;
+    visibleBodies.push_back(body);
+  }
+}
+
+bool FieldOfViewSensor::isInLineOfSight(const b2Vec2& origin, const b2Vec2& target, const Body* body) const
+{
+  class Callback : public b2RayCastCallback
+  {
+  public:
+    explicit Callback(const FieldOfViewSensor& sensor) :
+      sensor(sensor)
+    {}
+
+    b2Fixture* closest = nullptr; /**< The closest perceivable fixture on the ray. */
+
+  private:
+    float ReportFixture(b2Fixture* fixture, const b2Vec2&, const b2Vec2&, float fraction) override
+    {
+      if(!sensor.perceives(fixture))
+        return -1.f;
+      closest = fixture;
+      return fraction;
+    }
+
+    const FieldOfViewSensor& sensor; /**< The sensor that casts the ray. */
+  };
+
+  if(origin == target)
+    return true;
+  Callback callback(*this);
+  Simulation::simulation->world->RayCast(&callback, origin, target);
+  return !callback.closest || getRootBody(callback.closest) == body;
+}
+
+void FieldOfViewSensor::drawPhysics(QPainter& painter) const
+{
+  painter.save();
+  painter.setTransform(transformation, true);
+  QPolygonF polygon;
+  polygon << QPointF();
+  for(int i = 0; i <= 16; ++i)
+  {
+    const float angle = openingAngle * (static_cast<float>(i) / 16.f - 0.5f);
+    polygon << QPointF(std::cos(angle) * range, std::sin(angle) * range);
+  }
+  QPen pen(QColor(255, 255, 0, 160));
+  pen.setWidthF(0.005f);
+  painter.setPen(pen);
+  painter.setBrush(QColor(255, 255, 0, visibleBodies.empty() ? 24 : 64));
+  painter.drawPolygon(polygon);
+  ::PhysicalObject::drawPhysics(painter);
+  painter.restore();
+}
+
+FieldOfViewSensor::SensorType FieldOfViewSensor::getSensorType() const
+{
+  return visibilitySensor;
+}
+
+SimRobotCore2D::Body* const* FieldOfViewSensor::getVisibleBodies(unsigned int& count) const
+{
+  count = static_cast<unsigned int>(visibleBodies.size());
+  return visibleBodies.data();
+}
@@ -0,0 +1,53 @@
+/**
+ * @file FieldOfViewSensor.h
+ *
+ * This file declares a sensor that determines which bodies are within its field of view.
+ */
+
+#pragma once
+
+#include "Simulation/Sensors/Sensor.h"
+#include <vector>
+
+class FieldOfViewSensor : public Sensor
+{
+public:
+  float openingAngle = 0.f; /**< The angle of the field of view. */
+  bool occlusion = true; /**< Whether bodies that are hidden behind other geometries are invisible. */
+
+  /** Determines the bodies within the field of view. */
+  void updateValue() override;
+
+protected:
+  /**
+   * Draws the field of view.
+   * @param painter The drawing helper.
+   */
+  void drawPhysics(QPainter& painter) const override;
+
+  /**
+   * Returns the type of the sensor readings.
+   * @return The type.
+   */
+  [[nodiscard]] SensorType getSensorType() const override;
+
+  /**
+   * Returns the bodies seen in the most recent simulation step.
+   * @param count Is set to the number of bodies.
+   * @return The root bodies that are visible.
+   */
+  [[nodiscard]] SimRobotCore2D::Body* const* getVisibleBodies(unsigned int& count) const override;
+
+private:
+  /**
+   * Checks whether the line of sight to a point on a body is free.
+   * @param origin The position of the sensor in world coordinates.
+   * @param target The point in world coordinates.
+   * @param body The root body to which the point belongs.
+   * @return Whether the first geometry on the line of sight belongs to the body.
+   */
+  [[nodiscard]] bool isInLineOfSight(const b2Vec2& origin, const b2Vec2& target, const Body* body) const;
+
+  std::vector<Body*> candidates; /**< The bodies that have a fixture within the range in the current step (reused to avoid allocations). */
+  std::vector<SimRobotCore2D::Body*> visibleBodies; /**< The bodies seen in the most recent step. */
+};
@@ -0,0 +1,106 @@
+/**
+ * @file LaserSensor.cpp
+ *
+ * This file implements a sensor that measures distances along a fan of rays.
+ */
+
+#include "LaserSensor.h"
+#include "Simulation/Simulation.h"
+#include <box2d/b2_collision.h>
+#include <box2d/b2_fixture.h>
+#include <box2d/b2_world.h>
+#include <QPainter>
+#include <algorithm>
+#include <cmath>
+
+void LaserSensor::createPhysics()
+{
+  Sensor::createPhysics();
+
+  directions.resize(rays);
+  for(int i = 0; i < rays; ++i)
+  {
+    const float angle = rays == 1 ? 0.f : openingAngle * (static_cast<float>(i) / static_cast<float>(rays - 1) - 0.5f);
+    directions[i] = b2Vec2(std::cos(angle), std::sin(angle));
+  }
+  distances.assign(rays, range);
+}
+
+void LaserSensor::updateValue()
+{
+  const b2Transform pose = getWorldPose();
+
+  // The rays are segments from the sensor to their end points, so they lie within the bounding box of these points.
+  b2AABB boundingBox;
+  boundingBox.lowerBound = boundingBox.upperBound = pose.p;
+  for(const b2Vec2& direction : directions)
+  {
+    const b2Vec2 end = pose.p + range * b2Mul(pose.q, direction);
+    boundingBox.lowerBound = b2Min(boundingBox.lowerBound, end);
+    boundingBox.upperBound = b2Max(boundingBox.upperBound, end);
+  }
+
+  // Query the broadphase once for the whole fan instead of once per ray.
+  class Callback : public b2QueryCallback
+  {
+  public:
+    explicit Callback(LaserSensor& sensor) :
+      sensor(sensor)
+    {}
+
+  private:
+    bool ReportFixture(b2Fixture* fixture) override
+    {
+      if(sensor.perceives(fixture))
+        sensor.candidates.push_back(fixture);
+      return true;
+    }
+
+    LaserSensor& sensor; /**< The sensor that collects the candidates. */
+  };
+
+  candidates.clear();
+  Callback callback(*this);
+  Simulation::simulation->world->QueryAABB(&callback, boundingBox);
+
+  // Cast each ray against the candidates, shortening it whenever something is hit.
+  b2RayCastInput input;
+  input.p1 = pose.p;
+  for(int i = 0; i < rays; ++i)
+  {
+    input.p2 = pose.p + range * b2Mul(pose.q, directions[i]);
+    input.maxFraction = 1.f;
+    for(const b2Fixture* fixture : candidates)
+      for(int child = 0, count = fixture->GetShape()->GetChildCount(); child < count; ++child)
+      {
+        b2RayCastOutput output;
+        if(fixture->RayCast(&output, input, child))
+          input.maxFraction = std::min(input.maxFraction, output.fraction);
+      }
+    distances[i] = input.maxFraction * range;
+  }
+}
+
+void LaserSensor::drawPhysics(QPainter& painter) const
+{
+  painter.save();
+  painter.setTransform(transformation, true);
+  QPen pen(QColor(255, 0, 0, 128));
+  pen.setWidthF(0.005f);
+  painter.setPen(pen);
+  for(int i = 0; i < rays; ++i)
+    painter.drawLine(QPointF(), QPointF(directions[i].x * distances[i], directions[i].y * distances[i]));
+  ::PhysicalObject::drawPhysics(painter);
+  painter.restore();
+}
+
+LaserSensor::SensorType LaserSensor::getSensorType() const
+{
+  return distanceSensor;
+}
+
+const float* LaserSensor::getDistances(unsigned int& count) const
+{
+  count = static_cast<unsigned int>(distances.size());
+  return distances.data();
+}
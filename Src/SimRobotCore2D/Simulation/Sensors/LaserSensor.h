@@ -0,0 +1,50 @@
+/**
+ * @file LaserSensor.h
+ *
+ * This file declares a sensor that measures distances along a fan of rays.
+ */
+
+#pragma once
+
+#include "Simulation/Sensors/Sensor.h"
+#include <vector>
+
+class b2Fixture;
+
+class LaserSensor : public Sensor
+{
+public:
+  float openingAngle = 0.f; /**< The angle between the outermost rays. */
+  int rays = 1; /**< The number of rays (evenly distributed over the opening angle). */
+
+  /** Casts all rays against the geometries within the range of the sensor. */
+  void updateValue() override;
+
+protected:
+  /** Initializes the sensor and precomputes the directions of its rays. */
+  void createPhysics() override;
+
+  /**
+   * Draws the rays up to the measured distances.
+   * @param painter The drawing helper.
+   */
+  void drawPhysics(QPainter& painter) const override;
+
+  /**
+   * Returns the type of the sensor readings.
+   * @return The type.
+   */
+  [[nodiscard]] SensorType getSensorType() const override;
+
+  /**
+   * Returns the distances measured in the most recent simulation step.
+   * @param count Is set to the number of distances.
+   * @return The distances (in m).
+   */
+  [[nodiscard]] const float* getDistances(unsigned int& count) const override;
+
+private:
+  std::vector<b2Vec2> directions; /**< The direction of each ray relative to the sensor. */
+  std::vector<float> distances; /**< The distance measured along each ray. */
+  std::vector<b2Fixture*> candidates; /**< The fixtures that might be hit by a ray in the current step (reused to avoid allocations). */
+};
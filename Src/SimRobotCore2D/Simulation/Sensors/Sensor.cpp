@@ -0,0 +1,87 @@
+/**
+ * @file Sensor.cpp
+ *
+ * This file implements a base class for sensors that are attached to bodies.
+ */
+
+#include "Sensor.h"
+#include "Platform/Assert.h"
+#include "Simulation/Body.h"
+#include "Simulation/Simulation.h"
+#include "Tools/QtTools.h"
+#include <box2d/b2_body.h>
+#include <box2d/b2_fixture.h>
+
+void Sensor::createPhysics()
+{
+  // The parser only allows sensors as direct children of bodies, so the offset is just the own translation and rotation.
+  ASSERT(parentBody);
+  offset.SetIdentity();
+  if(translation)
+    offset.p = *translation;
+  if(rotation)
+    offset.q = *rotation;
+
+  ::PhysicalObject::createPhysics();
+  QtTools::convertTransformation(rotation, translation, transformation);
+
+  Simulation::simulation->sensors.push_back(this);
+}
+
+b2Transform Sensor::getWorldPose() const
+{
+  return b2Mul(parentBody->body->GetTransform(), offset);
+}
+
+bool Sensor::perceives(b2Fixture* fixture) const
+{
+  if(!(fixture->GetFilterData().categoryBits & mask))
+    return false;
+  const Body* const body = getRootBody(fixture);
+  return !body || body != parentBody->rootBody;
+}
+
+Body* Sensor::getRootBody(b2Fixture* fixture)
+{
+  b2Body* const body = fixture->GetBody();
+  if(body == Simulation::simulation->staticBody)
+    return nullptr;
+  return reinterpret_cast<Body*>(body->GetUserData().pointer)->rootBody;
+}
+
+const QString& Sensor::getFullName() const
+{
+  return SimObject::getFullName();
+}
+
+const QIcon* Sensor::getIcon() const
+{
+  return SimObject::getIcon();
+}
+
+SimRobot::Widget* Sensor::createWidget()
+{
+  return SimObject::createWidget();
+}
+
+SimRobotCore2D::Painter* Sensor::createPainter()
+{
+  return SimObject::createPainter();
+}
+
+float Sensor::getRange() const
+{
+  return range;
+}
+
+const float* Sensor::getDistances(unsigned int& count) const
+{
+  count = 0;
+  return nullptr;
+}
+
+SimRobotCore2D::Body* const* Sensor::getVisibleBodies(unsigned int& count) const
+{
+  count = 0;
+  return nullptr;
+}
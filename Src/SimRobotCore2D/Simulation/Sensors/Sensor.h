@@ -0,0 +1,94 @@
+/**
+ * @file Sensor.h
+ *
+ * This file declares a base class for sensors that are attached to bodies.
+ */
+
+#pragma once
+
+#include "Simulation/PhysicalObject.h"
+#include "SimRobotCore2D.h"
+#include <cstdint>
+
+class b2Fixture;
+
+class Sensor : public PhysicalObject, public SimRobotCore2D::SensorPort
+{
+public:
+  /** Computes the readings of the sensor from the current state of the world. */
+  virtual void updateValue() = 0;
+
+  float range = 0.f; /**< The maximum distance the sensor can measure or see. */
+  std::uint16_t mask = 0xffff; /**< The mask of geometry categories the sensor can perceive. */
+
+protected:
+  /** Initializes the sensor and registers it with the simulation. */
+  void createPhysics() override;
+
+  /**
+   * Returns the current pose of the sensor in world coordinates.
+   * @return The pose.
+   */
+  [[nodiscard]] b2Transform getWorldPose() const;
+
+  /**
+   * Returns whether the sensor can perceive a fixture, i.e. whether the fixture matches \c mask
+   * and does not belong to the body (or the bodies attached to it) that carries the sensor.
+   * @param fixture The fixture.
+   * @return Whether the fixture can be perceived.
+   */
+  [[nodiscard]] bool perceives(b2Fixture* fixture) const;
+
+  /**
+   * Returns the root body to which a fixture belongs.
+   * @param fixture The fixture.
+   * @return The root body or \c nullptr if the fixture belongs to a compound.
+   */
+  static Body* getRootBody(b2Fixture* fixture);
+
+  /**
+   * Returns the full path to the object in the scene graph.
+   * @return The full path ...
+   */
+  [[nodiscard]] const QString& getFullName() const override;
+
+  /**
+   * Returns an icon to visualize the object in the scene graph.
+   * @return An icon ...
+   */
+  [[nodiscard]] const QIcon* getIcon() const override;
+
+  /**
+   * Creates a widget for this object.
+   * @return The new widget instance.
+   */
+  SimRobot::Widget* createWidget() override;
+
+  /**
+   * Creates a painter for this object.
+   * @return The new painter instance.
+   */
+  SimRobotCore2D::Painter* createPainter() override;
+
+  /**
+   * Returns the maximum distance the sensor can measure or see.
+   * @return The range (in m).
+   */
+  [[nodiscard]] float getRange() const override;
+
+  /**
+   * Returns the distances measured by a distance sensor in the most recent simulation step.
+   * @param count Is set to the number of distances.
+   * @return The distances (in m).
+   */
+  [[nodiscard]] const float* getDistances(unsigned int& count) const override;
+
+  /**
+   * Returns the bodies a visibility sensor saw in the most recent simulation step.
+   * @param count Is set to the number of bodies.
+   * @return The root bodies that are visible.
+   */
+  [[nodiscard]] SimRobotCore2D::Body* const* getVisibleBodies(unsigned int& count) const override;
+
+  b2Transform offset; /**< The pose of the sensor relative to its parent body. */
+};
@@ -13,37 +13,43 @@
 #include "Parser/ElementCore2D.h"
 #include "Parser/ParserCore2D.h"
 #include "Simulation/Geometries/Geometry.h"
+#include "Simulation/Body.h"
 #include "Simulation/Scene.h"
+#include "Simulation/Sensors/Sensor.h"
 #include <box2d/b2_body.h>
 #include <box2d/b2_world.h>
 #include <box2d/b2_contact.h>
+#include <box2d/b2_fixture.h>
 
-Simulation* Simulation::simulation = nullptr;
-
-Simulation::Simulation()
-{
-  ASSERT(!simulation);
-  simulation = this;
-}
+thread_local Simulation* Simulation::simulation = nullptr;
 
 Simulation::~Simulation()
 {
-  for(ElementCore2D* element : elements)
-    delete element;
+  {
+    Scope scope(*this);
+
+    // The geometries are deleted while their fixtures still exist, so contacts must not be reported anymore.
+    if(world)
+      world->SetContactListener(nullptr);
+
+    for(ElementCore2D* element : elements)
+      delete element;
 
-  if(staticBody)
-    world->DestroyBody(staticBody);
+    if(staticBody)
+      world->DestroyBody(staticBody);
 
-  delete world;
+    delete world;
+  }
 
-  ASSERT(simulation == this);
-  simulation = nullptr;
+  if(simulation == this)
+    simulation = nullptr;
 }
 
 bool Simulation::loadFile(const std::string& fileName, std::list<std::string>& errors)
 {
   ASSERT(!scene);
   ASSERT(elements.empty());
+  Scope scope(*this);
 
   // Load the scene.
   ParserCore2D parser;
@@ -74,6 +80,7 @@ bool Simulation::loadFile(const std::string& fileName, std::list<std::string>& e
 
   scene->pose.SetIdentity();
   scene->createPhysics();
+  updateSensors();
 
   return true;
 }
@@ -87,37 +94,246 @@ void Simulation::registerObjects()
 
 void Simulation::doSimulationStep()
 {
+  Scope scope(*this);
+
   // Update internal variables.
   ++simulationStep;
   simulatedTime += scene->stepLength;
 
+  // Remember the poses of the bodies, between which painters interpolate.
+  if(scene->realTimeFactor > 0.f)
+    for(b2Body* body = world->GetBodyList(); body; body = body->GetNext())
+      if(body != staticBody)
+      {
+        Body* const simBody = reinterpret_cast<Body*>(body->GetUserData().pointer);
+        simBody->previousPosition = body->GetPosition();
+        simBody->previousAngle = body->GetAngle();
+      }
+
   // Execute the Box2D step.
   world->Step(scene->stepLength, scene->velocityIterations, scene->positionIterations);
 
-  // Report collisions that persist over multiple steps.
-  for(auto& contact : contacts)
+  // Report collisions that persist over multiple steps. Callbacks might unregister themselves, which changes the arrays.
+  for(std::size_t i = 0; i < geometriesWithCallbacks.size(); ++i)
+  {
+    Geometry& geometry = *geometriesWithCallbacks[i];
+    for(std::size_t j = 0; j < geometry.contacts.size(); ++j)
+    {
+      Geometry::Contact& contact = geometry.contacts[j];
+      if(contact.isNew)
+        contact.isNew = false;
+      else
+        for(SimRobotCore2D::CollisionCallback* callback : geometry.callbacks)
+          callback->collided(geometry, *contact.other);
+    }
+  }
+
+  updateSensors();
+
+  if(recorder.isOpen())
+    recordState();
+
+  updateFrameRate();
+}
+
+unsigned int Simulation::getDueSteps()
+{
+  if(scene->realTimeFactor <= 0.f || !CoreModule::application->isSimRunning())
+  {
+    stepTimer.reset();
+    renderInterpolation = 1.f;
+    return 1;
+  }
+
+  const unsigned int steps = stepTimer.getDueSteps(scene->stepLength, scene->realTimeFactor, scene->maxSubSteps);
+  renderInterpolation = stepTimer.getInterpolation();
+  return steps;
+}
+
+void Simulation::trackContacts(Geometry& geometry)
+{
+  ASSERT(geometry.contacts.empty());
+  geometry.callbackIndex = geometriesWithCallbacks.size();
+  geometriesWithCallbacks.push_back(&geometry);
+
+  // Contacts that are already touching are reported from the next step on.
+  if(!geometry.fixture)
+    return;
+  for(b2ContactEdge* edge = geometry.fixture->GetBody()->GetContactList(); edge; edge = edge->next)
+  {
+    b2Contact* const contact = edge->contact;
+    if(contact->IsTouching() && (contact->GetFixtureA() == geometry.fixture || contact->GetFixtureB() == geometry.fixture))
+    {
+      b2Fixture* const other = contact->GetFixtureA() == geometry.fixture ? contact->GetFixtureB() : contact->GetFixtureA();
+      geometry.contacts.push_back({contact, reinterpret_cast<Geometry*>(other->GetUserData().pointer), false});
+    }
+  }
+}
+
+void Simulation::untrackContacts(Geometry& geometry)
+{
+  ASSERT(geometriesWithCallbacks[geometry.callbackIndex] == &geometry);
+  geometriesWithCallbacks[geometry.callbackIndex] = geometriesWithCallbacks.back();
+  geometriesWithCallbacks[geometry.callbackIndex]->callbackIndex = geometry.callbackIndex;
+  geometriesWithCallbacks.pop_back();
+  geometry.contacts.clear();
+}
+
+void Simulation::updateSensors()
+{
+  for(Sensor* sensor : sensors)
+    sensor->updateValue();
+}
+
+bool Simulation::startRecording(const std::string& fileName)
+{
+  stopRecording();
+  if(!recorder.open(fileName, getStateSize() * sizeof(double)))
+    return false;
+  recordState();
+  return true;
+}
+
+void Simulation::stopRecording()
+{
+  if(recorder.isOpen())
+    recorder.close();
+}
+
+bool Simulation::startReplay(const std::string& fileName)
+{
+  stopReplay();
+  if(!replayer.open(fileName))
+    return false;
+  if(replayer.getFrameSize() != getStateSize() * sizeof(double) || !seekReplay(0))
   {
-    if(contact.second)
-      reportCollisions(contact.first);
-    else
-      contact.second = true;
+    replayer.close();
+    return false;
   }
+  return true;
+}
+
+void Simulation::stopReplay()
+{
+  replayer.close();
+  replayFrame = 0;
+}
+
+bool Simulation::seekReplay(unsigned int frame)
+{
+  if(!replayState(frame))
+    return false;
+
+  // There is nothing to interpolate from after a jump.
+  for(b2Body* body = world->GetBodyList(); body; body = body->GetNext())
+    if(body != staticBody)
+    {
+      Body* const simBody = reinterpret_cast<Body*>(body->GetUserData().pointer);
+      simBody->previousPosition = body->GetPosition();
+      simBody->previousAngle = body->GetAngle();
+    }
+  replayFrame = frame + 1;
+  return true;
+}
+
+void Simulation::doReplayStep()
+{
+  if(replayFrame >= replayer.getNumOfFrames())
+    return;
+
+  if(scene->realTimeFactor > 0.f)
+    for(b2Body* body = world->GetBodyList(); body; body = body->GetNext())
+      if(body != staticBody)
+      {
+        Body* const simBody = reinterpret_cast<Body*>(body->GetUserData().pointer);
+        simBody->previousPosition = body->GetPosition();
+        simBody->previousAngle = body->GetAngle();
+      }
+
+  if(replayState(replayFrame))
+    ++replayFrame;
 
   updateFrameRate();
 }
 
+std::size_t Simulation::getStateSize() const
+{
+  return 2 + static_cast<std::size_t>(world->GetBodyCount() - 1) * 6;
+}
+
+void Simulation::recordState()
+{
+  // The body list has the same order whenever the same scene is loaded.
+  state.resize(getStateSize());
+  double* value = state.data();
+  *value++ = simulationStep;
+  *value++ = simulatedTime;
+  for(const b2Body* body = world->GetBodyList(); body; body = body->GetNext())
+    if(body != staticBody)
+    {
+      *value++ = body->GetPosition().x;
+      *value++ = body->GetPosition().y;
+      *value++ = body->GetAngle();
+      *value++ = body->GetLinearVelocity().x;
+      *value++ = body->GetLinearVelocity().y;
+      *value++ = body->GetAngularVelocity();
+    }
+  recorder.write(state.data());
+}
+
+bool Simulation::replayState(unsigned int frame)
+{
+  Scope scope(*this);
+
+  state.resize(getStateSize());
+  if(!replayer.read(frame, state.data()))
+    return false;
+
+  const double* value = state.data();
+  simulationStep = static_cast<unsigned int>(*value++);
+  simulatedTime = *value++;
+  for(b2Body* body = world->GetBodyList(); body; body = body->GetNext())
+    if(body != staticBody)
+    {
+      body->SetTransform(b2Vec2(static_cast<float>(value[0]), static_cast<float>(value[1])), static_cast<float>(value[2]));
+      body->SetLinearVelocity(b2Vec2(static_cast<float>(value[3]), static_cast<float>(value[4])));
+      body->SetAngularVelocity(static_cast<float>(value[5]));
+      value += 6;
+    }
+
+  // The sensor readings only depend on the poses, so they are just computed again.
+  updateSensors();
+  return true;
+}
+
 void Simulation::BeginContact(b2Contact* contact)
 {
   ++collisions;
-  contacts[contact] = false;
+  auto* const geom1 = reinterpret_cast<Geometry*>(contact->GetFixtureA()->GetUserData().pointer);
+  auto* const geom2 = reinterpret_cast<Geometry*>(contact->GetFixtureB()->GetUserData().pointer);
+  if(!geom1->callbacks.empty())
+    geom1->contacts.push_back({contact, geom2, true});
+  if(!geom2->callbacks.empty())
+    geom2->contacts.push_back({contact, geom1, true});
 
   // Report already here because the contact might already end before the end of the time step.
-  reportCollisions(contact);
+  reportCollisions(*geom1, *geom2);
 }
 
 void Simulation::EndContact(b2Contact* contact)
 {
-  contacts.erase(contact);
+  // Remove the contact from the geometries that track it (swapping the last one into its place).
+  for(b2Fixture* fixture : {contact->GetFixtureA(), contact->GetFixtureB()})
+  {
+    std::vector<Geometry::Contact>& contacts = reinterpret_cast<Geometry*>(fixture->GetUserData().pointer)->contacts;
+    for(Geometry::Contact& entry : contacts)
+      if(entry.contact == contact)
+      {
+        entry = contacts.back();
+        contacts.pop_back();
+        break;
+      }
+  }
   --collisions;
 }
 
@@ -134,14 +350,11 @@ void Simulation::updateFrameRate()
   }
 }
 
-void Simulation::reportCollisions(b2Contact* contact)
+void Simulation::reportCollisions(Geometry& geom1, Geometry& geom2)
 {
-  auto* const geom1 = reinterpret_cast<Geometry*>(contact->GetFixtureA()->GetUserData().pointer);
-  auto* const geom2 = reinterpret_cast<Geometry*>(contact->GetFixtureB()->GetUserData().pointer);
-
-  for(SimRobotCore2D::CollisionCallback* callback : geom1->callbacks)
-    callback->collided(*geom1, *geom2);
+  for(SimRobotCore2D::CollisionCallback* callback : geom1.callbacks)
+    callback->collided(geom1, geom2);
 
-  for(SimRobotCore2D::CollisionCallback* callback : geom2->callbacks)
-    callback->collided(*geom2, *geom1);
+  for(SimRobotCore2D::CollisionCallback* callback : geom2.callbacks)
+    callback->collided(geom2, geom1);
 }
@@ -8,21 +8,52 @@
 
 #pragma once
 
+#include "Tools/QtTrajectoryLogCodec.h"
+#include "Tools/StepTimer.h"
 #include <box2d/b2_world_callbacks.h>
 #include <list>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 class b2Body;
 class b2World;
 class ElementCore2D;
+class Geometry;
 class Scene;
+class Sensor;
 
 class Simulation : public b2ContactListener
 {
 public:
+  /**
+   * Makes a simulation the current one of this thread while an object of this class exists.
+   * Several simulations can exist in one process, but each of them must only be used by one thread at a time.
+   */
+  class Scope
+  {
+  public:
+    /**
+     * Constructor.
+     * @param simulation The simulation that becomes the current one.
+     */
+    explicit Scope(Simulation& simulation) :
+      previous(Simulation::simulation)
+    {
+      Simulation::simulation = &simulation;
+    }
+
+    /** Destructor. Restores the previous simulation. */
+    ~Scope()
+    {
+      Simulation::simulation = previous;
+    }
+
+  private:
+    Simulation* previous; /**< The simulation that was current before. */
+  };
+
   /** Constructor. */
-  Simulation();
+  Simulation() = default;
 
   /** Destructor. */
   ~Simulation() override;
@@ -41,16 +72,75 @@ public:
   /** Executes one time step (frame) of the simulation. */
   void doSimulationStep();
 
-  static Simulation* simulation; /**< The only instance of this class. */
+  /**
+   * Determines how many steps are due to keep the simulated time in sync with the real time
+   * (scaled by \c Scene::realTimeFactor) and updates \c renderInterpolation accordingly.
+   * At most \c Scene::maxSubSteps steps are due, so a larger backlog is dropped. Without real time or if the
+   * simulation is stepped manually, exactly one step is due and the real time starts over when it runs again.
+   * @return The number of steps to execute now.
+   */
+  unsigned int getDueSteps();
+
+  /**
+   * Starts tracking the contacts of a geometry, which must be done while it has collision callbacks.
+   * @param geometry The geometry.
+   */
+  void trackContacts(Geometry& geometry);
+
+  /**
+   * Stops tracking the contacts of a geometry.
+   * @param geometry The geometry.
+   */
+  void untrackContacts(Geometry& geometry);
+
+  /** Updates the readings of all sensors at once (so the broadphase stays in the cache). */
+  void updateSensors();
+
+  /**
+   * Starts writing the state after each step to a log, beginning with the current state.
+   * @param fileName The name of the log file.
+   * @return Whether the file could be created.
+   */
+  bool startRecording(const std::string& fileName);
+
+  /** Stops writing the log and completes the file. */
+  void stopRecording();
+
+  /**
+   * Starts replaying a log instead of simulating, beginning with its first state.
+   * @param fileName The name of the log file.
+   * @return Whether the file is a log of a scene with the same number of bodies.
+   */
+  bool startReplay(const std::string& fileName);
+
+  /** Stops replaying, i.e. the simulation continues from the state replayed last. */
+  void stopReplay();
+
+  /**
+   * Jumps to a state in the replayed log.
+   * @param frame The index of the state in the log.
+   * @return Whether the state could be read.
+   */
+  bool seekReplay(unsigned int frame);
+
+  /** Advances the replay by one state (instead of \c doSimulationStep). */
+  void doReplayStep();
+
+  static thread_local Simulation* simulation; /**< The simulation that is loaded or stepped on this thread (on the GUI thread, the one of the module). */
   std::list<ElementCore2D*> elements; /**< All elements in the simulation. */
   Scene* scene = nullptr; /**< The scene that is being simulated. */
   unsigned int simulationStep = 0; /**< The step counter of the simulation. */
   double simulatedTime = 0.0; /**< The time that has elapsed since the start of the simulation. */
   unsigned int currentFrameRate = 0; /**< The average number of simulated frames per second. */
   unsigned int collisions = 0; /**< The number of collisions that started in the most recent frame. */
+  float renderInterpolation = 1.f; /**< Where painters draw the bodies between the previous (0) and the current step (1). */
 
   b2World* world = nullptr; /**< The Box2D world in which the physics happen. */
   b2Body* staticBody = nullptr; /**< The Box2D body to which compound fixtures are attached. */
+  std::vector<Sensor*> sensors; /**< All sensors in the scene, which are updated after each step. */
+  TrajectoryLogWriter recorder{qtTrajectoryLogCodec}; /**< Writes the states to a log while recording. */
+  TrajectoryLogReader replayer{qtTrajectoryLogCodec}; /**< Reads the states from a log while replaying. */
+  unsigned int replayFrame = 0; /**< The index of the next state to replay. */
 
 protected:
   /**
@@ -69,13 +159,32 @@ private:
   /** Updates the frame rate (if required). */
   void updateFrameRate();
 
+  /**
+   * Returns the number of values in a state as it is logged, i.e. the step, the time and the pose and velocity of each body.
+   * @return The number of values.
+   */
+  [[nodiscard]] std::size_t getStateSize() const;
+
+  /** Appends the current state to the log that is recorded. */
+  void recordState();
+
+  /**
+   * Reads a state from the replayed log and moves all bodies accordingly.
+   * @param frame The index of the state in the log.
+   * @return Whether the state could be read.
+   */
+  bool replayState(unsigned int frame);
+
   /**
    * Call collision callbacks for a contact.
-   * @param contact The contact.
+   * @param geom1 The first geometry of the contact.
+   * @param geom2 The second geometry of the contact.
    */
-  static void reportCollisions(b2Contact* contact);
+  static void reportCollisions(Geometry& geom1, Geometry& geom2);
 
   unsigned int lastFrameRateComputationTime = 0; /**< The (real) time when the frame rate was calculated. */
   unsigned int lastFrameRateComputationStep = 0; /**< The step number when the frame rate was calculated. */
-  std::unordered_map<b2Contact*, bool> contacts; /**< The active contacts + whether they should be additionally reported in \c doSimulationStep. */
+  StepTimer stepTimer; /**< Determines the number of steps that are due in real time. */
+  std::vector<double> state; /**< Buffer for a logged state. */
+  std::vector<Geometry*> geometriesWithCallbacks; /**< The geometries whose contacts are tracked to report them in \c doSimulationStep. */
 };
@@ -0,0 +1,47 @@
+/**
+ * @file SimulationBatch.cpp
+ *
+ * This file implements a class that runs many independent simulations of a scene in parallel without a GUI.
+ */
+
+#include "SimulationBatch.h"
+#include "Simulation/Simulation.h"
+#include <QtConcurrentMap>
+#include <numeric>
+
+SimulationBatch::~SimulationBatch() = default;
+
+bool SimulationBatch::load(const std::string& fileName, std::size_t count, std::list<std::string>& errors)
+{
+  simulations.clear();
+  simulations.reserve(count);
+
+  // The parser is not meant to run concurrently, so the simulations are loaded one after another.
+  for(std::size_t i = 0; i < count; ++i)
+  {
+    if(!simulations.emplace_back(std::make_unique<Simulation>())->loadFile(fileName, errors))
+    {
+      simulations.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+void SimulationBatch::run(unsigned int steps, const StepCallback& callback)
+{
+  std::vector<std::size_t> indices(simulations.size());
+  std::iota(indices.begin(), indices.end(), 0);
+  QtConcurrent::blockingMap(indices, [this, steps, &callback](std::size_t index)
+  {
+    // Each simulation is only touched by the thread that took it, so there is nothing to lock.
+    Simulation& simulation = *simulations[index];
+    Simulation::Scope scope(simulation);
+    for(unsigned int i = 0; i < steps; ++i)
+    {
+      if(callback)
+        callback(index, simulation);
+      simulation.doSimulationStep();
+    }
+  });
+}
@@ -0,0 +1,65 @@
+/**
+ * @file SimulationBatch.h
+ *
+ * This file declares a class that runs many independent simulations of a scene in parallel without a GUI.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Simulation;
+
+class SimulationBatch
+{
+public:
+  /**
+   * Is called for each simulation before each of its steps (on the thread that steps the simulation).
+   * It can control the simulation and collect its results, but it must only access data of that simulation.
+   * @param index The index of the simulation in the batch.
+   * @param simulation The simulation.
+   */
+  using StepCallback = std::function<void(std::size_t index, Simulation& simulation)>;
+
+  /** Destructor. */
+  ~SimulationBatch();
+
+  /**
+   * Loads a scene description file into a number of independent simulations.
+   * @param fileName The name of the file to load.
+   * @param count The number of simulations to create.
+   * @param errors A list which is filled with messages about errors during loading.
+   * @return Whether all simulations were loaded successfully (otherwise, the batch is empty).
+   */
+  bool load(const std::string& fileName, std::size_t count, std::list<std::string>& errors);
+
+  /**
+   * Advances all simulations by a number of steps. The simulations are distributed among the threads of
+   * the global thread pool, each thread taking the next simulation that has not been stepped yet. Simulations
+   * do not wait for each other, since their worlds are independent.
+   * @param steps The number of steps to execute per simulation.
+   * @param callback An optional function that is called before each step of each simulation.
+   */
+  void run(unsigned int steps, const StepCallback& callback = StepCallback());
+
+  /**
+   * Returns the number of simulations.
+   * @return The number of simulations.
+   */
+  [[nodiscard]] std::size_t size() const {return simulations.size();}
+
+  /**
+   * Accesses a simulation (e.g. to collect its results after \c run).
+   * @param index The index of the simulation.
+   * @return The simulation.
+   */
+  [[nodiscard]] Simulation& operator[](std::size_t index) const {return *simulations[index];}
+
+private:
+  std::vector<std::unique_ptr<Simulation>> simulations; /**< The simulations. */
+};
@@ -0,0 +1,127 @@
+/**
+ * @file SimulationBatchTest.cpp
+ *
+ * This file implements a test that steps several 2D simulations in parallel and checks that each of them
+ * ends up exactly where the same simulation ends up when it is stepped alone.
+ */
+
+#include "Simulation/Body.h"
+#include "Simulation/Scene.h"
+#include "Simulation/Simulation.h"
+#include "Simulation/SimulationBatch.h"
+#include <box2d/b2_body.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace
+{
+  constexpr std::size_t numOfSimulations = 8;
+  constexpr unsigned int numOfSteps = 500;
+
+  /** A ball in a closed box, so it keeps bouncing around. */
+  constexpr const char* sceneDescription = R"(<Simulation>
+  <Scene name="BatchTest" stepLength="0.01s">
+    <Compound name="box">
+      <ChainGeometry loop="true">
+2 -1
+-2 -1
+-2 1
+2 1
+      </ChainGeometry>
+    </Compound>
+    <Body name="ball">
+      <DiskGeometry radius="50mm"/>
+      <DiskMass radius="50mm" value="45g"/>
+    </Body>
+  </Scene>
+</Simulation>
+)";
+
+  /**
+   * Gives the ball of a simulation a velocity that depends on the index of the simulation.
+   * @param index The index of the simulation.
+   * @param simulation The simulation, which must not have been stepped yet.
+   */
+  void kick(std::size_t index, Simulation& simulation)
+  {
+    b2Body* const ball = simulation.scene->bodies.front()->body;
+    ball->SetLinearVelocity(b2Vec2(0.5f + 0.25f * static_cast<float>(index), 0.3f));
+  }
+
+  /**
+   * Returns the position of the ball of a simulation.
+   * @param simulation The simulation.
+   * @return The position of the ball.
+   */
+  b2Vec2 getBallPosition(const Simulation& simulation)
+  {
+    return simulation.scene->bodies.front()->body->GetPosition();
+  }
+
+  /**
+   * Checks whether two positions are exactly the same.
+   * @param a The first position.
+   * @param b The second position.
+   * @return Whether they are equal.
+   */
+  bool isEqual(const b2Vec2& a, const b2Vec2& b)
+  {
+    return a.x == b.x && a.y == b.y;
+  }
+}
+
+int main()
+{
+  const std::filesystem::path fileName = std::filesystem::temp_directory_path() / "SimulationBatchTest.ros2d";
+  std::ofstream(fileName) << sceneDescription;
+
+  std::list<std::string> errors;
+  SimulationBatch batch;
+  if(!batch.load(fileName.string(), numOfSimulations, errors) || batch.size() != numOfSimulations)
+  {
+    for(const std::string& error : errors)
+      std::fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+
+  std::vector<unsigned int> stepsPerSimulation(numOfSimulations, 0);
+  batch.run(numOfSteps, [&stepsPerSimulation](std::size_t index, Simulation& simulation)
+  {
+    if(!stepsPerSimulation[index]++)
+      kick(index, simulation);
+  });
+
+  int result = 0;
+  for(std::size_t i = 0; i < numOfSimulations; ++i)
+  {
+    // The same scene, stepped alone on this thread, is the reference.
+    Simulation reference;
+    if(!reference.loadFile(fileName.string(), errors))
+      return 1;
+    kick(i, reference);
+    for(unsigned int step = 0; step < numOfSteps; ++step)
+      reference.doSimulationStep();
+
+    const b2Vec2 position = getBallPosition(batch[i]);
+    const b2Vec2 expected = getBallPosition(reference);
+    if(stepsPerSimulation[i] != numOfSteps || batch[i].simulationStep != numOfSteps || !isEqual(position, expected))
+    {
+      std::fprintf(stderr, "Simulation %zu: %u steps, ball at (%f, %f) instead of (%f, %f)\n", i, batch[i].simulationStep,
+                   static_cast<double>(position.x), static_cast<double>(position.y), static_cast<double>(expected.x), static_cast<double>(expected.y));
+      result = 1;
+    }
+    for(std::size_t j = 0; j < i; ++j)
+      if(isEqual(getBallPosition(batch[j]), position))
+      {
+        std::fprintf(stderr, "Simulations %zu and %zu did not run independently\n", j, i);
+        result = 1;
+      }
+  }
+
+  std::filesystem::remove(fileName);
+  return result;
+}
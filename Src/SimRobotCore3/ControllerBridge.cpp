@@ -0,0 +1,333 @@
+/**
+ * @file ControllerBridge.cpp
+ * Implementation of class ControllerBridge
+ */
+
+#include "ControllerBridge.h"
+#include "CoreModule.h"
+#include "Platform/Assert.h"
+#include "Platform/System.h"
+#include "Simulation/Scene.h"
+#include <QString>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <new>
+
+#ifndef WINDOWS
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef MACOS
+#include <thread>
+#else
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+ControllerBridge::~ControllerBridge()
+{
+#ifndef WINDOWS
+  for(Channel& channel : channels)
+    if(channel.header)
+    {
+      munmap(channel.header, channel.header->size);
+      shm_unlink(channel.name.c_str());
+    }
+#endif
+}
+
+bool ControllerBridge::create(Mode mode, unsigned int timeout, std::list<std::string>& errors)
+{
+  ASSERT(channels.empty());
+  this->mode = mode;
+  this->timeout = timeout;
+#ifdef WINDOWS
+  errors.emplace_back("The controller bridge is not supported on this platform.");
+  return false;
+#else
+  SimRobot::Application& application = *CoreModule::application;
+  const ::Scene& scene = *Simulation::simulation->scene;
+
+  // Collect the ports below each top-level object of the scene.
+  std::function<void(const SimRobot::Object&, Channel&)> collectPorts = [&](const SimRobot::Object& object, Channel& channel)
+  {
+    for(int i = 0, count = application.getObjectChildCount(object); i < count; ++i)
+    {
+      SimRobot::Object* child = application.getObjectChild(object, i);
+      if(child->getKind() == SimRobotCore3::sensorPort)
+      {
+        SimRobotCore3::SensorPort* sensor = static_cast<SimRobotCore3::SensorPort*>(child);
+        if(sensor->getSensorType() != SimRobotCore3::SensorPort::noSensor)
+          channel.sensors.push_back(sensor);
+      }
+      else if(child->getKind() == SimRobotCore3::actuatorPort)
+        channel.actuators.push_back(static_cast<SimRobotCore3::ActuatorPort*>(child));
+      collectPorts(*child, channel);
+    }
+  };
+
+  for(int i = 0, count = application.getObjectChildCount(scene); i < count; ++i)
+  {
+    const SimRobot::Object& robot = *application.getObjectChild(scene, i);
+    Channel channel;
+    collectPorts(robot, channel);
+    if(channel.sensors.empty() && channel.actuators.empty())
+      continue;
+    channel.name = getSegmentName(scene.name, robot.getFullName().section('.', -1).toStdString(), channels);
+    if(!map(channel, errors))
+      return false;
+    channels.push_back(std::move(channel));
+  }
+
+  if(channels.empty())
+    errors.emplace_back("The controller bridge did not find any robots with sensors or actuators.");
+  return !channels.empty();
+#endif
+}
+
+std::string ControllerBridge::getSegmentName(const std::string& scene, const std::string& robot, const std::vector<Channel>& channels)
+{
+#ifdef MACOS
+  constexpr std::size_t maxLength = 31; // PSHMNAMLEN
+#else
+  constexpr std::size_t maxLength = 255; // NAME_MAX
+#endif
+  // The name must start with the only slash it contains.
+  std::string name = "/SimRobot." + scene + "." + robot;
+  for(auto i = name.begin() + 1; i != name.end(); ++i)
+    if(!(*i >= 'a' && *i <= 'z') && !(*i >= 'A' && *i <= 'Z') && !(*i >= '0' && *i <= '9') && *i != '-' && *i != '_' && *i != '.')
+      *i = '_';
+  if(name.size() > maxLength)
+    name.resize(maxLength);
+
+  // Replacing and truncating characters can map different robots to the same name.
+  const auto isUsed = [&channels](const std::string& candidate)
+  {
+    return std::any_of(channels.begin(), channels.end(), [&candidate](const Channel& channel) {return channel.name == candidate;});
+  };
+  const std::string base = name;
+  for(unsigned int i = 2; isUsed(name); ++i)
+  {
+    const std::string suffix = "-" + std::to_string(i);
+    name = base.substr(0, std::min(base.size(), maxLength - suffix.size())) + suffix;
+  }
+  return name;
+}
+
+bool ControllerBridge::unlinkStaleSegment(const std::string& name)
+{
+#ifdef WINDOWS
+  static_cast<void>(name);
+  return false;
+#else
+  const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if(fd == -1)
+    return false;
+  struct stat status;
+  void* memory = fstat(fd, &status) == 0 && status.st_size >= static_cast<off_t>(sizeof(Header))
+                 ? mmap(nullptr, sizeof(Header), PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+  close(fd);
+  if(memory == MAP_FAILED)
+    return false;
+
+  // Only segments of this bridge are touched, and only if their simulator has terminated.
+  const Header& header = *static_cast<const Header*>(memory);
+  const bool stale = header.magic == magic && header.simulatorPid
+                     && kill(static_cast<pid_t>(header.simulatorPid), 0) == -1 && errno == ESRCH;
+  munmap(memory, sizeof(Header));
+  return stale && shm_unlink(name.c_str()) == 0;
+#endif
+}
+
+bool ControllerBridge::map(Channel& channel, std::list<std::string>& errors)
+{
+#ifdef WINDOWS
+  static_cast<void>(channel);
+  static_cast<void>(errors);
+  return false;
+#else
+  // Determine the layout of the segment.
+  const std::size_t numOfPorts = channel.sensors.size() + channel.actuators.size();
+  std::vector<PortEntry> entries(numOfPorts);
+  std::size_t offset = sizeof(Header) + numOfPorts * sizeof(PortEntry);
+  auto addEntry = [&offset](PortEntry& entry, const QString& name, std::uint32_t type, std::size_t size)
+  {
+    std::strncpy(entry.name, name.toUtf8().constData(), sizeof(entry.name) - 1);
+    entry.type = type;
+    offset = (offset + 7) & ~std::size_t(7);
+    entry.offset = static_cast<std::uint32_t>(offset);
+    entry.size = static_cast<std::uint32_t>(size);
+    offset += size;
+  };
+  PortEntry* entry = entries.data();
+  for(SimRobotCore3::SensorPort* sensor : channel.sensors)
+  {
+    std::size_t size = 1;
+    for(int dimension : sensor->getDimensions())
+      size *= dimension;
+    switch(sensor->getSensorType())
+    {
+      case SimRobotCore3::SensorPort::boolSensor:
+      case SimRobotCore3::SensorPort::floatSensor:
+        size = sizeof(float);
+        break;
+      case SimRobotCore3::SensorPort::floatArraySensor:
+        size *= sizeof(float);
+        break;
+      default:
+        break;
+    }
+    addEntry(*entry++, sensor->getFullName(), sensor->getSensorType(), size);
+  }
+  for(SimRobotCore3::ActuatorPort* actuator : channel.actuators)
+    addEntry(*entry++, actuator->getFullName(), 0xffffffff, sizeof(float));
+
+  // Create and map the segment. An existing segment may belong to another simulator that is still running.
+  int fd = shm_open(channel.name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if(fd == -1 && errno == EEXIST && unlinkStaleSegment(channel.name))
+    fd = shm_open(channel.name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if(fd == -1)
+  {
+    if(errno == EEXIST)
+      errors.emplace_back("Shared memory segment " + channel.name + " is already used by another process.");
+    else
+      errors.emplace_back("Could not create shared memory segment " + channel.name + ": " + std::strerror(errno));
+    return false;
+  }
+  void* memory = ftruncate(fd, static_cast<off_t>(offset)) == 0 ? mmap(nullptr, offset, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+  close(fd);
+  if(memory == MAP_FAILED)
+  {
+    errors.emplace_back("Could not map shared memory segment " + channel.name + ": " + std::strerror(errno));
+    shm_unlink(channel.name.c_str());
+    return false;
+  }
+
+  Header* header = new(memory) Header;
+  header->magic = magic;
+  header->version = version;
+  header->mode = mode;
+  header->numOfSensors = static_cast<std::uint32_t>(channel.sensors.size());
+  header->numOfActuators = static_cast<std::uint32_t>(channel.actuators.size());
+  header->size = static_cast<std::uint32_t>(offset);
+  header->simulatorPid = static_cast<std::uint32_t>(getpid());
+  header->sensorSequence = 0;
+  header->actuatorSequence = 0;
+  header->controllerPid = 0;
+  header->simulationStep = 0;
+  header->simulatedTime = 0.;
+  std::memcpy(reinterpret_cast<PortEntry*>(header + 1), entries.data(), numOfPorts * sizeof(PortEntry));
+  channel.header = header;
+  return true;
+#endif
+}
+
+void ControllerBridge::update()
+{
+  // Publish the sensor values of all robots first, so that the controllers can run in parallel.
+  for(Channel& channel : channels)
+  {
+    Header& header = *channel.header;
+    char* const base = reinterpret_cast<char*>(&header);
+    const PortEntry* entry = reinterpret_cast<const PortEntry*>(&header + 1);
+    for(SimRobotCore3::SensorPort* sensor : channel.sensors)
+    {
+      const SimRobotCore3::SensorPort::Data data = sensor->getValue();
+      char* value = base + entry->offset;
+      switch(entry->type)
+      {
+        case SimRobotCore3::SensorPort::boolSensor:
+          *reinterpret_cast<float*>(value) = data.boolValue ? 1.f : 0.f;
+          break;
+        case SimRobotCore3::SensorPort::floatSensor:
+          *reinterpret_cast<float*>(value) = data.floatValue;
+          break;
+        case SimRobotCore3::SensorPort::cameraSensor:
+          std::memcpy(value, data.byteArray, entry->size);
+          break;
+        case SimRobotCore3::SensorPort::floatArraySensor:
+          std::memcpy(value, data.floatArray, entry->size);
+          break;
+      }
+      ++entry;
+    }
+    header.simulationStep = Simulation::simulation->simulationStep;
+    header.simulatedTime = Simulation::simulation->simulatedTime;
+    header.sensorSequence.fetch_add(1, std::memory_order_release);
+    wake(header.sensorSequence);
+  }
+
+  // Collect the answers.
+  for(Channel& channel : channels)
+  {
+    Header& header = *channel.header;
+    if(mode == lockstep && header.controllerPid.load(std::memory_order_relaxed))
+    {
+      const std::uint32_t sequence = header.sensorSequence.load(std::memory_order_relaxed);
+      const unsigned int startTime = System::getTime();
+      for(;;)
+      {
+        const std::uint32_t answer = header.actuatorSequence.load(std::memory_order_acquire);
+        if(answer == sequence)
+          break;
+        const unsigned int timeWaited = System::getTime() - startTime;
+        if(timeWaited >= timeout)
+        {
+#ifndef WINDOWS
+          // Detach controllers that terminated without saying goodbye.
+          const pid_t pid = static_cast<pid_t>(header.controllerPid.load(std::memory_order_relaxed));
+          if(pid && kill(pid, 0) == -1 && errno == ESRCH)
+            header.controllerPid = 0;
+#endif
+          break;
+        }
+        wait(header.actuatorSequence, answer, timeout - timeWaited);
+      }
+    }
+    applyActuators(channel);
+  }
+}
+
+void ControllerBridge::applyActuators(Channel& channel)
+{
+  Header& header = *channel.header;
+  const std::uint32_t answer = header.actuatorSequence.load(std::memory_order_acquire);
+  if(answer == channel.answeredSequence)
+    return;
+  channel.answeredSequence = answer;
+  const char* const base = reinterpret_cast<const char*>(&header);
+  const PortEntry* entry = reinterpret_cast<const PortEntry*>(&header + 1) + header.numOfSensors;
+  for(SimRobotCore3::ActuatorPort* actuator : channel.actuators)
+    actuator->setValue(*reinterpret_cast<const float*>(base + (entry++)->offset));
+}
+
+void ControllerBridge::wait(std::atomic<std::uint32_t>& sequence, std::uint32_t value, unsigned int timeout)
+{
+#ifdef WINDOWS
+  static_cast<void>(sequence);
+  static_cast<void>(value);
+  static_cast<void>(timeout);
+#elif defined MACOS
+  // There is no public futex API, so poll with short sleeps.
+  for(const unsigned int startTime = System::getTime(); sequence.load(std::memory_order_acquire) == value && System::getTime() - startTime < timeout;)
+    std::this_thread::sleep_for(std::chrono::microseconds(20));
+#else
+  const struct timespec ts = {static_cast<time_t>(timeout / 1000), static_cast<long>(timeout % 1000) * 1000000l};
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&sequence), FUTEX_WAIT, value, &ts, nullptr, 0);
+#endif
+}
+
+void ControllerBridge::wake(std::atomic<std::uint32_t>& sequence)
+{
+#if defined WINDOWS || defined MACOS
+  static_cast<void>(sequence);
+#else
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&sequence), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+#endif
+}
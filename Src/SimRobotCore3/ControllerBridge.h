@@ -0,0 +1,164 @@
+/**
+ * @file ControllerBridge.h
+ * Declaration of class ControllerBridge, which exposes the sensor and actuator
+ * ports of each robot in the scene to controllers running in other processes.
+ *
+ * Every robot (i.e. every top-level object of the scene that contains ports)
+ * gets its own shared memory segment named "/SimRobot.<scene>.<robot>". Characters
+ * other than letters, digits, '.', '-' and '_' in the scene and robot names are replaced
+ * by '_' and long names are truncated (to 31 characters on macOS and 255 otherwise). If two
+ * robots end up with the same name, a suffix "-<n>" is added to the later one. A segment
+ * that already exists is only replaced if the simulator that created it is no longer running. The
+ * segment starts with a \c ControllerBridge::Header, followed by a table of
+ * \c ControllerBridge::PortEntry (sensors first, then actuators) and the data
+ * area the entries point into. The header is plain data, so an external
+ * controller can use this file without linking against SimRobot.
+ *
+ * Protocol (both sequence numbers are futex words on Linux):
+ *   - The simulator writes all sensor values and increments \c sensorSequence.
+ *   - The controller waits for \c sensorSequence to change, reads the sensor
+ *     values, writes the actuator values and sets \c actuatorSequence to the
+ *     value of \c sensorSequence it answers.
+ *   - In lockstep mode, the simulator waits for all connected controllers
+ *     to answer before it performs the next simulation step. In free-running
+ *     mode, it just uses the latest actuator values that were written.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace SimRobotCore3
+{
+  class SensorPort;
+  class ActuatorPort;
+}
+
+/**
+ * @class ControllerBridge
+ * Publishes sensor values and applies actuator values through shared memory.
+ */
+class ControllerBridge
+{
+public:
+  static constexpr std::uint32_t magic = 0x53524342; /**< "SRCB" */
+  static constexpr std::uint32_t version = 2;
+
+  /** The synchronization modes */
+  enum Mode : std::uint32_t
+  {
+    off,
+    lockstep, /**< The simulation waits for every connected controller in each step. */
+    freeRunning /**< The simulation never waits for controllers. */
+  };
+
+  /** The start of each shared memory segment */
+  struct Header
+  {
+    std::uint32_t magic; /**< Always \c ControllerBridge::magic */
+    std::uint32_t version; /**< Always \c ControllerBridge::version */
+    std::uint32_t mode; /**< A value of \c Mode */
+    std::uint32_t numOfSensors; /**< The number of sensor entries in the port table */
+    std::uint32_t numOfActuators; /**< The number of actuator entries in the port table (following the sensors) */
+    std::uint32_t size; /**< The size of the whole segment in bytes */
+    std::uint32_t simulatorPid; /**< The process id of the simulator that created the segment */
+    std::atomic<std::uint32_t> sensorSequence; /**< Incremented by the simulator after the sensor values were written */
+    std::atomic<std::uint32_t> actuatorSequence; /**< Set by the controller to the \c sensorSequence it answered */
+    std::atomic<std::uint32_t> controllerPid; /**< Set by the controller while it is attached, 0 otherwise */
+    std::uint32_t simulationStep; /**< The simulation step the sensor values belong to */
+    double simulatedTime; /**< The simulated time in seconds the sensor values belong to */
+  };
+
+  /** A description of a port in the port table */
+  struct PortEntry
+  {
+    char name[112]; /**< The full name of the port (zero-terminated, possibly truncated) */
+    std::uint32_t type; /**< The \c SimRobotCore3::SensorPort::SensorType or 0xffffffff for actuators */
+    std::uint32_t offset; /**< The offset of the value from the start of the segment */
+    std::uint32_t size; /**< The size of the value in bytes */
+    std::uint32_t reserved;
+  };
+
+  static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "Shared memory synchronization requires lock-free atomics");
+
+  /** Destructor */
+  ~ControllerBridge();
+
+  /**
+   * Creates the shared memory segments for all robots in the scene.
+   * @param mode The synchronization mode
+   * @param timeout The time in ms the simulation waits for a controller in lockstep mode before considering it detached
+   * @param errors The errors that occurred
+   * @return Whether at least one segment was created
+   */
+  bool create(Mode mode, unsigned int timeout, std::list<std::string>& errors);
+
+  /**
+   * Publishes the current sensor values, waits for the controllers (in lockstep mode)
+   * and applies their actuator values. Should be called before each simulation step.
+   */
+  void update();
+
+private:
+  /** The shared memory segment of a robot and the ports it exposes */
+  struct Channel
+  {
+    std::string name; /**< The name of the shared memory segment */
+    Header* header = nullptr; /**< The mapped segment */
+    std::vector<SimRobotCore3::SensorPort*> sensors; /**< The sensors in the order of the port table */
+    std::vector<SimRobotCore3::ActuatorPort*> actuators; /**< The actuators in the order of the port table */
+    std::uint32_t answeredSequence = 0; /**< The last \c actuatorSequence whose values were applied */
+  };
+
+  Mode mode = off; /**< The synchronization mode */
+  unsigned int timeout = 0; /**< The time in ms to wait for a controller in lockstep mode */
+  std::vector<Channel> channels; /**< One channel per robot */
+
+  /**
+   * Builds the name of the shared memory segment of a robot.
+   * @param scene The name of the scene
+   * @param robot The name of the robot
+   * @param channels The channels created so far, whose names must not be reused
+   * @return A valid name for \c shm_open
+   */
+  static std::string getSegmentName(const std::string& scene, const std::string& robot, const std::vector<Channel>& channels);
+
+  /**
+   * Removes a shared memory segment if it was created by a simulator that is no longer running.
+   * @param name The name of the segment
+   * @return Whether the segment was removed
+   */
+  static bool unlinkStaleSegment(const std::string& name);
+
+  /**
+   * Maps a shared memory segment for a channel and fills in its header and port table.
+   * @param channel The channel with its name and ports already set
+   * @param errors The errors that occurred
+   * @return Whether the segment was created
+   */
+  bool map(Channel& channel, std::list<std::string>& errors);
+
+  /**
+   * Copies the actuator values of a channel to the actuator ports.
+   * @param channel The channel
+   */
+  void applyActuators(Channel& channel);
+
+  /**
+   * Blocks until a sequence number differs from a given value or the timeout has elapsed.
+   * @param sequence The sequence number
+   * @param value The value to wait for changing
+   * @param timeout The maximum time in ms to wait
+   */
+  static void wait(std::atomic<std::uint32_t>& sequence, std::uint32_t value, unsigned int timeout);
+
+  /**
+   * Wakes up all processes waiting for a sequence number.
+   * @param sequence The sequence number
+   */
+  static void wake(std::atomic<std::uint32_t>& sequence);
+};
@@ -60,6 +60,19 @@ bool CoreModule::compile()
   registerObjects();
   application->registerObject(*this, actuatorsObject, 0, SimRobot::Flag::hidden);
 
+  // expose ports to external controllers
+  if(scene->bridgeMode != ControllerBridge::off && !controllerBridge.create(scene->bridgeMode, scene->bridgeTimeout, errors))
+  {
+    QString errorMessage;
+    for(const std::string& error : errors)
+    {
+      if(!errorMessage.isEmpty())
+        errorMessage += "\n";
+      errorMessage += error.c_str();
+    }
+    application->showWarning(QObject::tr("SimRobotCore3"), errorMessage);
+  }
+
   // register status bar labels
   class StepsLabel : public QLabel, public SimRobot::StatusLabel
   {
@@ -112,6 +125,24 @@ bool CoreModule::compile()
     }
   };
 
+  class LoadLabel : public QLabel, public SimRobot::StatusLabel
+  {
+  public:
+    LoadLabel()
+    {
+      char buf[65];
+      sprintf(buf, "loaded in %u ms", Simulation::simulation->loadTime);
+      setText(buf);
+      sprintf(buf, "%.1f MB of mesh data", static_cast<double>(Simulation::simulation->graphicsContext.getBufferMemorySize()) / (1024. * 1024.));
+      setToolTip(buf);
+    }
+
+  private:
+    QWidget* getWidget() override {return this;}
+    void update() override {}
+  };
+
+  application->addStatusLabel(*this, new LoadLabel());
   application->addStatusLabel(*this, new StepsLabel());
   application->addStatusLabel(*this, new StepsPerSecondLabel());
   application->addStatusLabel(*this, new CollisionsLabel());
@@ -127,7 +158,24 @@ bool CoreModule::compile()
 
 void CoreModule::update()
 {
+  if(replayer.isOpen())
+  {
+    // Replays only advance through the log, so neither actuators nor controllers are needed.
+    for(unsigned int steps = getDueSteps(); steps > 0; --steps)
+      doReplayStep();
+    return;
+  }
+
   if(ActuatorsWidget::actuatorsWidget)
     ActuatorsWidget::actuatorsWidget->adoptActuators();
-  doSimulationStep();
+  for(unsigned int steps = getDueSteps(); steps > 0; --steps)
+  {
+    controllerBridge.update();
+    doSimulationStep();
+  }
+}
+
+unsigned int CoreModule::getUpdatePeriod() const
+{
+  return scene->realTimeFactor > 0.f ? static_cast<unsigned int>(scene->stepLength / scene->realTimeFactor * 1000000.f) : 0;
 }
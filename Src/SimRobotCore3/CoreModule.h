@@ -7,6 +7,7 @@
 #pragma once
 
 #include "ActuatorsWidget.h"
+#include "ControllerBridge.h"
 #include "Simulation/Simulation.h"
 #include <SimRobot.h>
 #include <QIcon>
@@ -31,6 +32,7 @@ public:
   QIcon sliderIcon;
   QIcon appearanceIcon;
   ActuatorsObject actuatorsObject;
+  ControllerBridge controllerBridge; /**< Exposes the ports to controllers in other processes */
 
   /**
    * Constructor
@@ -50,4 +52,10 @@ private:
 
   /** Called to perform another simulation step */
   void update() override;
+
+  /**
+   * Returns how often \c update should be called, i.e. once per step if the scene runs in real time
+   * @return The time between two updates in microseconds or 0 if updates should happen as often as possible
+   */
+  unsigned int getUpdatePeriod() const override;
 };
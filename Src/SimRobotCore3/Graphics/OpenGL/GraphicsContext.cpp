@@ -10,12 +10,29 @@
 #include "Graphics/Light.h"
 #include "Platform/Assert.h"
 #include "Simulation/Simulation.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFloat16>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QImage>
 #include <QOffscreenSurface>
 #include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
 #include <QOpenGLFramebufferObject>
 #include <QOpenGLFunctions_3_3_Core>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrentRun>
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <unordered_set>
 
 // The following shader source code is based on https://learnopengl.com/Lighting/Multiple-lights
 // and https://learnopengl.com/PBR/Lighting.
@@ -31,10 +48,12 @@ out vec2 TexCoords;
 
 uniform mat4 cameraPV;
 uniform mat4 modelMatrix;
+uniform vec3 positionScale;
+uniform vec3 positionOffset;
 
 void main()
 {
-  FragPosInWorld = vec3(modelMatrix * vec4(inPosInModel, 1.0));
+  FragPosInWorld = vec3(modelMatrix * vec4(inPosInModel * positionScale + positionOffset, 1.0));
   NormalInWorld = mat3(modelMatrix) * inNormalInModel;
   TexCoords = inTexCoords;
   gl_Position = cameraPV * vec4(FragPosInWorld, 1.0);
@@ -46,10 +65,12 @@ layout(location = 0) in vec3 inPosInModel;
 
 uniform mat4 cameraPV;
 uniform mat4 modelMatrix;
+uniform vec3 positionScale;
+uniform vec3 positionOffset;
 
 void main()
 {
-  gl_Position = cameraPV * modelMatrix * vec4(inPosInModel, 1.0);
+  gl_Position = cameraPV * modelMatrix * vec4(inPosInModel * positionScale + positionOffset, 1.0);
 }
 )glsl";
 
@@ -245,11 +266,18 @@ void main()
 
 GraphicsContext::GraphicsContext()
 {
-  vertexBuffers.resize(2);
+  vertexBuffers.resize(6);
   vertexBuffers[VertexPN::index].setupVertexAttributes = VertexPN::setupVertexAttributes;
   vertexBuffers[VertexPN::index].stride = VertexPN::size;
   vertexBuffers[VertexPNT::index].setupVertexAttributes = VertexPNT::setupVertexAttributes;
   vertexBuffers[VertexPNT::index].stride = VertexPNT::size;
+  vertexBuffers[getPackedIndex(false, false)].setupVertexAttributes = setupPackedVertexAttributes<false, false>;
+  vertexBuffers[getPackedIndex(false, true)].setupVertexAttributes = setupPackedVertexAttributes<false, true>;
+  vertexBuffers[getPackedIndex(true, false)].setupVertexAttributes = setupPackedVertexAttributes<true, false>;
+  vertexBuffers[getPackedIndex(true, true)].setupVertexAttributes = setupPackedVertexAttributes<true, true>;
+  for(bool quantized : {false, true})
+    for(bool withTextureCoordinates : {false, true})
+      vertexBuffers[getPackedIndex(quantized, withTextureCoordinates)].stride = getPackedSize(quantized, withTextureCoordinates);
 }
 
 GraphicsContext::~GraphicsContext()
@@ -272,6 +300,8 @@ GraphicsContext::~GraphicsContext()
   delete offscreenContext;
   delete offscreenSurface;
 
+  for(auto& pair : preloadedTextures)
+    delete pair.second.result();
   for(const auto& texture : textures)
     delete texture.second;
   for(const auto& modelMatrixSet : modelMatrixSets)
@@ -294,6 +324,19 @@ GraphicsContext::~GraphicsContext()
 
 void GraphicsContext::compile()
 {
+  // Simplify large meshes (this adds index buffers).
+  for(Mesh* mesh : meshes)
+    createLODs(*mesh);
+
+  // Move the vertex buffers into compact categories.
+  for(std::size_t index : {VertexPN::index, VertexPNT::index})
+  {
+    std::vector<VertexBufferBase*> buffers;
+    buffers.swap(vertexBuffers[index].buffers);
+    for(VertexBufferBase* buffer : buffers)
+      vertexBuffers[(buffer->vaoIndex = packVertexBuffer(*buffer))].buffers.push_back(buffer);
+  }
+
   // Determine buffer memory layout of vertex buffer.
   GLint base = 0;
   GLintptr offset = 0;
@@ -541,6 +584,172 @@ GraphicsContext::Mesh* GraphicsContext::requestMesh(const VertexBufferBase* vert
   return mesh;
 }
 
+std::size_t GraphicsContext::packVertexBuffer(VertexBufferBase& buffer) const
+{
+  const bool withTextureCoordinates = buffer.getTextureCoordinates(0) != nullptr;
+
+  // Half floats are precise enough for texture coordinates near [0, 1], but not for large tiling factors.
+  if(withTextureCoordinates)
+    for(std::size_t i = 0; i < buffer.count; ++i)
+      for(const float coordinate : *buffer.getTextureCoordinates(i))
+        if(std::abs(static_cast<float>(qfloat16(coordinate)) - coordinate) > maxTextureCoordinateError)
+          return buffer.vaoIndex;
+
+  // Quantize positions if the bounding box is small enough.
+  Vector3f min = Vector3f::Constant(std::numeric_limits<float>::max());
+  Vector3f max = Vector3f::Constant(std::numeric_limits<float>::lowest());
+  for(std::size_t i = 0; i < buffer.count; ++i)
+  {
+    min = min.cwiseMin(buffer.getPosition(i));
+    max = max.cwiseMax(buffer.getPosition(i));
+  }
+  const Vector3f scale = (max - min) / 65535.f;
+  buffer.quantized = scale.maxCoeff() * 0.5f <= maxPositionError;
+  if(buffer.quantized)
+  {
+    buffer.positionScale = scale;
+    buffer.positionOffset = min;
+  }
+
+  const std::uint32_t vertexSize = getPackedSize(buffer.quantized, withTextureCoordinates);
+  buffer.packedData.resize(static_cast<std::size_t>(buffer.count) * vertexSize);
+  unsigned char* vertex = buffer.packedData.data();
+  auto packNormalComponent = [](float value) -> std::uint32_t
+  {
+    return static_cast<std::uint32_t>(static_cast<std::int32_t>(std::round(std::clamp(value, -1.f, 1.f) * 511.f))) & 0x3ff;
+  };
+  for(std::size_t i = 0; i < buffer.count; ++i, vertex += vertexSize)
+  {
+    const Vector3f& position = buffer.getPosition(i);
+    if(buffer.quantized)
+    {
+      std::uint16_t quantizedPosition[4] = {0};
+      for(int j = 0; j < 3; ++j)
+        quantizedPosition[j] = scale[j] > 0.f ? static_cast<std::uint16_t>(std::lround((position[j] - min[j]) / scale[j])) : 0;
+      std::memcpy(vertex, quantizedPosition, 8);
+    }
+    else
+      std::memcpy(vertex, position.data(), 12);
+    unsigned char* attributes = vertex + (buffer.quantized ? 8 : 12);
+
+    // Normals from scene or mesh files are not necessarily normalized.
+    const Vector3f normal = buffer.getNormal(i).normalized();
+    const std::uint32_t packedNormal = packNormalComponent(normal.x()) | packNormalComponent(normal.y()) << 10 | packNormalComponent(normal.z()) << 20;
+    std::memcpy(attributes, &packedNormal, 4);
+
+    if(withTextureCoordinates)
+    {
+      const Vector2f& textureCoordinates = *buffer.getTextureCoordinates(i);
+      const qfloat16 packedTextureCoordinates[2] = {qfloat16(textureCoordinates.x()), qfloat16(textureCoordinates.y())};
+      std::memcpy(attributes + 4, packedTextureCoordinates, 4);
+    }
+  }
+
+  // The packed vertices are kept for contexts that do not share the buffers, but the original ones are not needed anymore.
+  buffer.releaseVertices();
+  buffer.data = buffer.packedData.data();
+  buffer.vertexSize = vertexSize;
+  return getPackedIndex(buffer.quantized, withTextureCoordinates);
+}
+
+void GraphicsContext::createLODs(Mesh& mesh)
+{
+  if(mesh.mode != GL_TRIANGLES || !mesh.indexBuffer || mesh.indexBuffer->indices.size() < 3 * lodMinTriangles)
+    return;
+  const VertexBufferBase& vertexBuffer = *mesh.vertexBuffer;
+  const std::vector<std::uint32_t>& indices = mesh.indexBuffer->indices;
+
+  // Determine the bounds of the vertices used by the mesh.
+  Vector3f min = Vector3f::Constant(std::numeric_limits<float>::max());
+  Vector3f max = Vector3f::Constant(std::numeric_limits<float>::lowest());
+  for(const std::uint32_t index : indices)
+  {
+    const Vector3f& position = vertexBuffer.getPosition(index);
+    min = min.cwiseMin(position);
+    max = max.cwiseMax(position);
+  }
+  mesh.center = (min + max) * 0.5f;
+  mesh.radius = (max - min).norm() * 0.5f;
+  const float extent = (max - min).maxCoeff();
+  if(extent <= 0.f)
+    return;
+
+  // Cluster the vertices on grids with 64, 32, ... cells along the longest side. Each cluster is represented
+  // by the first vertex that falls into it, so that the simplified meshes can share the vertex buffer.
+  const std::uint32_t invalid = std::numeric_limits<std::uint32_t>::max();
+  std::vector<std::uint32_t> representatives(vertexBuffer.count);
+  std::unordered_map<std::uint64_t, std::uint32_t> cells;
+  struct TriangleHasher
+  {
+    std::size_t operator()(const std::array<std::uint32_t, 3>& triangle) const
+    {
+      return static_cast<std::size_t>((triangle[0] * 0x9e3779b97f4a7c15ull) ^ (triangle[1] * 0xc2b2ae3d27d4eb4full) ^ triangle[2]);
+    }
+  };
+  std::unordered_set<std::array<std::uint32_t, 3>, TriangleHasher> triangles;
+  std::size_t previousSize = indices.size();
+  for(int resolution = 64; resolution >= 4; resolution /= 2)
+  {
+    const float cellSize = extent / static_cast<float>(resolution);
+    std::fill(representatives.begin(), representatives.end(), invalid);
+    cells.clear();
+    triangles.clear();
+    auto getRepresentative = [&](std::uint32_t index) -> std::uint32_t
+    {
+      std::uint32_t& representative = representatives[index];
+      if(representative == invalid)
+      {
+        const Vector3f cell = (vertexBuffer.getPosition(index) - min) / cellSize;
+        const std::uint64_t key = static_cast<std::uint64_t>(cell.x()) | static_cast<std::uint64_t>(cell.y()) << 21 | static_cast<std::uint64_t>(cell.z()) << 42;
+        representative = cells.emplace(key, index).first->second;
+      }
+      return representative;
+    };
+
+    IndexBuffer* indexBuffer = new IndexBuffer;
+    for(std::size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+      std::uint32_t i1 = getRepresentative(indices[i]);
+      std::uint32_t i2 = getRepresentative(indices[i + 1]);
+      std::uint32_t i3 = getRepresentative(indices[i + 2]);
+      if(i1 == i2 || i2 == i3 || i3 == i1)
+        continue;
+      // Drop duplicates. Rotating the smallest index to the front preserves the orientation.
+      while(i1 > i2 || i1 > i3)
+      {
+        const std::uint32_t i0 = i1;
+        i1 = i2;
+        i2 = i3;
+        i3 = i0;
+      }
+      if(!triangles.insert({i1, i2, i3}).second)
+        continue;
+      indexBuffer->indices.insert(indexBuffer->indices.end(), {i1, i2, i3});
+    }
+
+    // Only keep levels that at least halve the number of triangles.
+    if(indexBuffer->indices.empty() || indexBuffer->indices.size() * 2 > previousSize)
+    {
+      const bool stop = indexBuffer->indices.empty();
+      delete indexBuffer;
+      if(stop)
+        break;
+      continue;
+    }
+    previousSize = indexBuffer->indices.size();
+    indexBuffer->indices.shrink_to_fit();
+    indexBuffers.push_back(indexBuffer);
+    mesh.lods.push_back({indexBuffer, cellSize * std::sqrt(3.f)});
+  }
+}
+
+void GraphicsContext::preloadTexture(const std::string& file)
+{
+  if(textures.contains(file) || preloadedTextures.contains(file))
+    return;
+  preloadedTextures.emplace(file, QtConcurrent::run([file]{return new Texture(file);}));
+}
+
 GraphicsContext::Texture* GraphicsContext::requestTexture(const std::string& file)
 {
   auto iter = textures.find(file);
@@ -550,7 +759,13 @@ GraphicsContext::Texture* GraphicsContext::requestTexture(const std::string& fil
     return texture->data ? texture : nullptr;
   }
   Texture*& texture = textures[file];
-  texture = new Texture(file);
+  if(auto preloaded = preloadedTextures.find(file); preloaded != preloadedTextures.end())
+  {
+    texture = preloaded->second.result();
+    preloadedTextures.erase(preloaded);
+  }
+  else
+    texture = new Texture(file);
   return texture->data ? texture : nullptr;
 }
 
@@ -665,6 +880,12 @@ void GraphicsContext::updateModelMatrices(ModelMatrix::Usage usage, bool forceUp
     modelMatrix->updateMemory();
 }
 
+void GraphicsContext::invalidateModelMatrices()
+{
+  for(ModelMatrixSet& modelMatrixSet : modelMatrixSets)
+    modelMatrixSet.lastUpdate = -1;
+}
+
 void GraphicsContext::startRendering(const Matrix4f& projection, const Matrix4f& view, int viewportX, int viewportY, int viewportWidth, int viewportHeight, bool lighting, bool textures, bool smoothShading, bool fillPolygons)
 {
   ASSERT(data);
@@ -681,12 +902,27 @@ void GraphicsContext::startRendering(const Matrix4f& projection, const Matrix4f&
   f->glUseProgram(shader->program);
   const Matrix4f pv = projection * view;
   f->glUniformMatrix4fv(shader->cameraPVLocation, 1, GL_FALSE, pv.data());
+
+  // Determine how large things appear in order to select levels of detail.
+  if(viewportX < 0)
+  {
+    GLint viewport[4];
+    f->glGetIntegerv(GL_VIEWPORT, viewport);
+    viewportWidth = viewport[2];
+    viewportHeight = viewport[3];
+  }
+  lodViewZ = view.row(2).transpose();
+  lodPerspective = projection(3, 2) != 0.f;
+  lodScale = std::max(std::abs(projection(0, 0)) * static_cast<float>(viewportWidth), std::abs(projection(1, 1)) * static_cast<float>(viewportHeight)) * 0.5f;
   if(shader->cameraPosLocation >= 0)
   {
     const Vector3f pos = -view.topLeftCorner<3, 3>().transpose() * view.topRightCorner<3, 1>();
     f->glUniform3fv(shader->cameraPosLocation, 1, pos.data());
   }
   f->glBindBufferBase(GL_UNIFORM_BUFFER, 0, data->ubo);
+  f->glUniform3f(shader->positionScaleLocation, 1.f, 1.f, 1.f);
+  f->glUniform3f(shader->positionOffsetLocation, 0.f, 0.f, 0.f);
+  positionsQuantized = false;
 
   // Controller drawings might have changed these states in the meantime:
   data->boundVAO = 0;
@@ -714,10 +950,36 @@ void GraphicsContext::draw(const Mesh* mesh, const ModelMatrix* modelMatrix, con
   if(newVAO != data->boundVAO)
     f->glBindVertexArray((data->boundVAO = newVAO));
   f->glUniformMatrix4fv(shader->modelMatrixLocation, 1, GL_FALSE, modelMatrix->memory.data());
+  if(mesh->vertexBuffer->quantized || positionsQuantized)
+  {
+    f->glUniform3fv(shader->positionScaleLocation, 1, mesh->vertexBuffer->positionScale.data());
+    f->glUniform3fv(shader->positionOffsetLocation, 1, mesh->vertexBuffer->positionOffset.data());
+    positionsQuantized = mesh->vertexBuffer->quantized;
+  }
   if(!forcedSurface)
     setSurface(surface);
-  if(mesh->indexBuffer)
-    f->glDrawElementsBaseVertex(mesh->mode, mesh->indexBuffer->count, mesh->indexBuffer->type, reinterpret_cast<void*>(mesh->indexBuffer->offset), mesh->vertexBuffer->base);
+
+  // Select the coarsest level of detail whose error would not be visible.
+  const IndexBuffer* indexBuffer = mesh->indexBuffer;
+  if(!mesh->lods.empty() && lodScale > 0.f)
+  {
+    float depth = 1.f;
+    if(lodPerspective)
+      depth = -lodViewZ.dot(modelMatrix->memory * mesh->center.homogeneous()) - mesh->radius;
+    if(depth > 0.f)
+    {
+      const float maxError = maxLODError * depth / lodScale;
+      for(const Mesh::LOD& lod : mesh->lods)
+      {
+        if(lod.error > maxError)
+          break;
+        indexBuffer = lod.indexBuffer;
+      }
+    }
+  }
+
+  if(indexBuffer)
+    f->glDrawElementsBaseVertex(mesh->mode, indexBuffer->count, indexBuffer->type, reinterpret_cast<void*>(indexBuffer->offset), mesh->vertexBuffer->base);
   else
     f->glDrawArrays(mesh->mode, mesh->vertexBuffer->base, mesh->vertexBuffer->count);
 }
@@ -765,6 +1027,7 @@ bool GraphicsContext::startOffscreenRendering(int width, int height, bool depthO
 
   f->glClear((depthOnly ? 0 : GL_COLOR_BUFFER_BIT) | GL_DEPTH_BUFFER_BIT);
   renderDepthOnly = depthOnly;
+  maxLODError = sensorLODError;
 
   return true;
 }
@@ -805,6 +1068,7 @@ bool GraphicsContext::startExternalRendering()
 
   f->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   renderDepthOnly = false;
+  maxLODError = viewLODError;
 
   return true;
 }
@@ -847,6 +1111,13 @@ void GraphicsContext::setSurface(const Surface* surface)
 GLuint GraphicsContext::compileShader(const std::vector<const char*>& vertexShaderSources, const std::vector<const char*>& fragmentShaderSources)
 {
   ASSERT(f);
+
+  // Compiling the shaders takes noticeable time (in particular with software rendering), so reuse the result of earlier runs.
+  const std::string binaryFileName = getProgramBinaryFileName(vertexShaderSources, fragmentShaderSources);
+  if(!binaryFileName.empty())
+    if(const GLuint program = loadProgramBinary(binaryFileName); program)
+      return program;
+
 #ifndef NDEBUG
   GLint success = 0;
 #endif
@@ -885,6 +1156,8 @@ GLuint GraphicsContext::compileShader(const std::vector<const char*>& vertexShad
   ASSERT(program > 0);
   f->glAttachShader(program, vertexShader);
   f->glAttachShader(program, fragmentShader);
+  if(!binaryFileName.empty())
+    QOpenGLContext::currentContext()->extraFunctions()->glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
   f->glLinkProgram(program);
 #ifndef NDEBUG
   f->glGetProgramiv(program, GL_LINK_STATUS, &success);
@@ -900,9 +1173,92 @@ GLuint GraphicsContext::compileShader(const std::vector<const char*>& vertexShad
   f->glDeleteShader(vertexShader);
   f->glDeleteShader(fragmentShader);
 
+  if(!binaryFileName.empty())
+    saveProgramBinary(program, binaryFileName);
+
   return program;
 }
 
+std::string GraphicsContext::getProgramBinaryFileName(const std::vector<const char*>& vertexShaderSources, const std::vector<const char*>& fragmentShaderSources) const
+{
+  ASSERT(f);
+  const QOpenGLContext* context = QOpenGLContext::currentContext();
+  if(context->format().version() < qMakePair(4, 1) && !context->hasExtension("GL_ARB_get_program_binary"))
+    return std::string();
+  GLint numOfFormats = 0;
+  f->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numOfFormats);
+  const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/SimRobotCore3/shaders";
+  if(numOfFormats <= 0 || !QDir().mkpath(cacheDir))
+    return std::string();
+
+  // 64 bit FNV-1a over the driver identification and the source code
+  std::uint64_t hash = 14695981039346656037ull;
+  const auto add = [&hash](const char* string)
+  {
+    for(; *string; ++string)
+      hash = (hash ^ static_cast<unsigned char>(*string)) * 1099511628211ull;
+    hash = hash * 1099511628211ull;
+  };
+  for(GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+    add(reinterpret_cast<const char*>(f->glGetString(name)));
+  for(const char* source : vertexShaderSources)
+    add(source);
+  add("");
+  for(const char* source : fragmentShaderSources)
+    add(source);
+
+  return (cacheDir + QString("/%1.bin").arg(hash, 16, 16, QChar('0'))).toStdString();
+}
+
+GLuint GraphicsContext::loadProgramBinary(const std::string& fileName) const
+{
+  ASSERT(f);
+  QFile file(QString::fromStdString(fileName));
+  if(!file.open(QIODevice::ReadOnly))
+    return 0;
+  const QByteArray content = file.readAll();
+  GLenum format;
+  if(content.size() <= static_cast<qsizetype>(sizeof(format)))
+    return 0;
+  std::memcpy(&format, content.constData(), sizeof(format));
+
+  const GLuint program = f->glCreateProgram();
+  ASSERT(program > 0);
+  QOpenGLContext::currentContext()->extraFunctions()->glProgramBinary(program, format, content.constData() + sizeof(format), static_cast<GLsizei>(content.size() - static_cast<qsizetype>(sizeof(format))));
+
+  // The driver rejects binaries of other versions, in which case the program is compiled again.
+  GLint success = 0;
+  f->glGetProgramiv(program, GL_LINK_STATUS, &success);
+  if(!success)
+  {
+    f->glDeleteProgram(program);
+    return 0;
+  }
+  return program;
+}
+
+void GraphicsContext::saveProgramBinary(GLuint program, const std::string& fileName) const
+{
+  ASSERT(f);
+  GLint length = 0;
+  f->glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if(length <= 0)
+    return;
+  GLenum format;
+  QByteArray content(static_cast<qsizetype>(sizeof(format)) + length, Qt::Uninitialized);
+  QOpenGLContext::currentContext()->extraFunctions()->glGetProgramBinary(program, length, &length, &format, content.data() + sizeof(format));
+  std::memcpy(content.data(), &format, sizeof(format));
+  content.truncate(static_cast<qsizetype>(sizeof(format)) + length);
+
+  // Other simulator instances might load the same binary at the same time, so replace the file atomically.
+  QSaveFile file(QString::fromStdString(fileName));
+  if(file.open(QIODevice::WriteOnly))
+  {
+    file.write(content);
+    file.commit();
+  }
+}
+
 GraphicsContext::Shader GraphicsContext::compileColorShader(bool lighting, bool textures, bool smooth)
 {
   const char* versionSourceCode = "#version 330 core\n";
@@ -937,6 +1293,8 @@ GraphicsContext::Shader GraphicsContext::compileColorShader(bool lighting, bool
   shader.cameraPosLocation = f->glGetUniformLocation(shader.program, "cameraPos");
   shader.modelMatrixLocation = f->glGetUniformLocation(shader.program, "modelMatrix");
   shader.surfaceIndexLocation = f->glGetUniformLocation(shader.program, "surfaceIndex");
+  shader.positionScaleLocation = f->glGetUniformLocation(shader.program, "positionScale");
+  shader.positionOffsetLocation = f->glGetUniformLocation(shader.program, "positionOffset");
   return shader;
 }
 
@@ -950,6 +1308,8 @@ GraphicsContext::Shader GraphicsContext::compileDepthOnlyShader()
   ASSERT(f);
   shader.cameraPVLocation = f->glGetUniformLocation(shader.program, "cameraPV");
   shader.modelMatrixLocation = f->glGetUniformLocation(shader.program, "modelMatrix");
+  shader.positionScaleLocation = f->glGetUniformLocation(shader.program, "positionScale");
+  shader.positionOffsetLocation = f->glGetUniformLocation(shader.program, "positionOffset");
   return shader;
 }
 
@@ -981,8 +1341,40 @@ void GraphicsContext::VertexPNT::setupVertexAttributes(QOpenGLFunctions_3_3_Core
   functions.glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), reinterpret_cast<void*>(6 * sizeof(GLfloat)));
 }
 
+template<bool quantized, bool withTextureCoordinates>
+void GraphicsContext::setupPackedVertexAttributes(QOpenGLFunctions_3_3_Core& functions)
+{
+  constexpr GLsizei stride = getPackedSize(quantized, withTextureCoordinates);
+  constexpr GLenum positionType = quantized ? GL_UNSIGNED_SHORT : GL_FLOAT;
+  constexpr std::size_t normalOffset = quantized ? 8 : 12;
+  functions.glEnableVertexAttribArray(0);
+  functions.glVertexAttribPointer(0, 3, positionType, GL_FALSE, stride, reinterpret_cast<void*>(0));
+  functions.glEnableVertexAttribArray(1);
+  functions.glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, reinterpret_cast<void*>(normalOffset));
+  functions.glEnableVertexAttribArray(2);
+  if constexpr(withTextureCoordinates)
+    functions.glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(normalOffset + 4));
+  else
+    functions.glVertexAttribPointer(2, 2, positionType, GL_FALSE, stride, reinterpret_cast<void*>(0));
+}
+
 GraphicsContext::Texture::Texture(const std::string& file)
 {
+  // The cache is indexed by a digest of the absolute path and invalidated by the modification time.
+  // The path itself is stored in the cache file as well, so that files of different textures are never mixed up.
+  const QFileInfo fileInfo(QString::fromStdString(file));
+  const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/SimRobotCore3/textures";
+  QString cacheFileName;
+  QByteArray sourcePath;
+  const qint64 lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+  if(fileInfo.exists() && !cacheDir.isEmpty() && QDir().mkpath(cacheDir))
+  {
+    sourcePath = fileInfo.absoluteFilePath().toUtf8();
+    cacheFileName = cacheDir + "/" + QString::fromLatin1(QCryptographicHash::hash(sourcePath, QCryptographicHash::Sha1).toHex()) + ".tex";
+    if(loadFromCache(cacheFileName, sourcePath, lastModified))
+      return;
+  }
+
   QImage image;
   if(!image.load(file.c_str()))
     return;
@@ -994,7 +1386,8 @@ GraphicsContext::Texture::Texture(const std::string& file)
   height = image.height();
   byteOrder = image.format() == QImage::Format_RGB888 ? GL_BGR : GL_BGRA;
   hasAlpha = image.hasAlphaChannel();
-  data = new GLubyte[image.sizeInBytes()];
+  size = static_cast<std::size_t>(image.sizeInBytes());
+  data = new GLubyte[size];
   if(!data)
     return;
 
@@ -1004,6 +1397,76 @@ GraphicsContext::Texture::Texture(const std::string& file)
     std::memcpy(p, image.scanLine(y), image.bytesPerLine());
     p += image.bytesPerLine();
   }
+
+  if(!cacheFileName.isEmpty())
+    saveToCache(cacheFileName, sourcePath, lastModified);
+}
+
+namespace
+{
+  /** The header of a cached texture, which is followed by the path of the texture file and the texture data. */
+  struct CachedTextureHeader
+  {
+    std::uint32_t magic; /**< Always \c cachedTextureMagic */
+    std::int32_t width; /**< The width of the texture in pixels. */
+    std::int32_t height; /**< The height of the texture in pixels. */
+    std::uint32_t byteOrder; /**< The format of the texture data. */
+    std::uint32_t hasAlpha; /**< Whether the texture has an alpha channel. */
+    std::uint32_t pathLength; /**< The length of the UTF-8 encoded absolute path of the texture file. */
+    std::int64_t lastModified; /**< The modification time of the texture file in ms since the epoch. */
+  };
+  constexpr std::uint32_t cachedTextureMagic = 0x58545253; /**< "SRTX" */
+}
+
+bool GraphicsContext::Texture::loadFromCache(const QString& cacheFileName, const QByteArray& sourcePath, qint64 lastModified)
+{
+  QFile file(cacheFileName);
+  CachedTextureHeader header;
+  if(!file.open(QIODevice::ReadOnly) || file.read(reinterpret_cast<char*>(&header), sizeof(header)) != static_cast<qint64>(sizeof(header)) ||
+     header.magic != cachedTextureMagic || header.lastModified != lastModified ||
+     header.pathLength != static_cast<std::uint32_t>(sourcePath.size()) || file.read(header.pathLength) != sourcePath)
+    return false;
+  // The rows are aligned to 4 bytes (the default GL_UNPACK_ALIGNMENT), like those of a QImage.
+  if(header.width <= 0 || header.height <= 0 || (header.byteOrder != GL_BGR && header.byteOrder != GL_BGRA))
+    return false;
+  const qint64 bytesPerLine = (static_cast<qint64>(header.width) * (header.byteOrder == GL_BGR ? 3 : 4) + 3) & ~qint64(3);
+  const qint64 dataSize = bytesPerLine * header.height;
+  if(file.size() - static_cast<qint64>(sizeof(header)) - header.pathLength != dataSize)
+    return false;
+  data = new GLubyte[dataSize];
+  if(file.read(reinterpret_cast<char*>(data), dataSize) != dataSize)
+  {
+    delete[] data;
+    data = nullptr;
+    return false;
+  }
+  size = static_cast<std::size_t>(dataSize);
+  width = header.width;
+  height = header.height;
+  byteOrder = header.byteOrder;
+  hasAlpha = header.hasAlpha != 0;
+  return true;
+}
+
+void GraphicsContext::Texture::saveToCache(const QString& cacheFileName, const QByteArray& sourcePath, qint64 lastModified) const
+{
+  CachedTextureHeader header;
+  header.magic = cachedTextureMagic;
+  header.width = width;
+  header.height = height;
+  header.byteOrder = byteOrder;
+  header.hasAlpha = hasAlpha;
+  header.pathLength = static_cast<std::uint32_t>(sourcePath.size());
+  header.lastModified = lastModified;
+
+  QSaveFile file(cacheFileName);
+  if(file.open(QIODevice::WriteOnly))
+  {
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(sourcePath);
+    file.write(reinterpret_cast<const char*>(data), static_cast<qint64>(size));
+    file.commit();
+  }
 }
 
 GraphicsContext::Texture::~Texture()
@@ -12,9 +12,11 @@
 #include "Tools/Math/Eigen.h"
 #include "Tools/Math/Pose3f.h"
 #include <stack>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include <QFuture>
 #include <qopengl.h>
 #undef near
 #undef far
@@ -103,15 +105,47 @@ public:
      * Returns the size of this buffer in bytes.
      * @return The size of this buffer in bytes.
      */
-    virtual std::size_t size() const = 0;
+    std::size_t size() const
+    {
+      return static_cast<std::size_t>(count) * vertexSize;
+    }
+
+    /**
+     * Returns the position of a vertex.
+     * @param index The index of the vertex.
+     * @return The position of the vertex.
+     */
+    virtual const Vector3f& getPosition(std::size_t index) const = 0;
+
+    /**
+     * Returns the normal of a vertex.
+     * @param index The index of the vertex.
+     * @return The normal of the vertex.
+     */
+    virtual const Vector3f& getNormal(std::size_t index) const = 0;
+
+    /**
+     * Returns the texture coordinates of a vertex.
+     * @param index The index of the vertex.
+     * @return The texture coordinates of the vertex or \c nullptr if the vertex type does not have any.
+     */
+    virtual const Vector2f* getTextureCoordinates(std::size_t index) const = 0;
+
+    /** Frees the vertices in their original format (after they have been packed into \c packedData). */
+    virtual void releaseVertices() = 0;
 
     void* data = nullptr; /**< Pointer to the vertex data. */
     std::uint32_t count = 0; /**< The number of vertices in this buffer. */
+    std::uint32_t vertexSize = 0; /**< The size of a vertex in \c data in bytes. */
 
   private:
     int base = 0; /**< The index of the first vertex within the global VBO. */
     std::uint64_t offset = 0; /**< The offset of this buffer's memory within the VBO. */
     std::size_t vaoIndex = 0; /**< The index of the VAO this buffer belongs to. */
+    std::vector<unsigned char> packedData; /**< The vertices in a compact format (replaces \c data if not empty). */
+    bool quantized = false; /**< Whether the positions in \c packedData are quantized to 16 bit. */
+    Vector3f positionScale = Vector3f::Ones(); /**< The factors that convert quantized positions back to m. */
+    Vector3f positionOffset = Vector3f::Zero(); /**< The offset that is added to the positions after the scaling. */
 
     friend class GraphicsContext;
   };
@@ -130,17 +164,48 @@ public:
     {
       data = vertices.data();
       count = static_cast<std::uint32_t>(vertices.size());
+      vertexSize = VertexType::size;
       ASSERT(count);
     }
 
   private:
     /**
-     * Returns the size of this buffer in bytes.
-     * @return The size of this buffer in bytes.
+     * Returns the position of a vertex.
+     * @param index The index of the vertex.
+     * @return The position of the vertex.
+     */
+    const Vector3f& getPosition(std::size_t index) const override
+    {
+      return vertices[index].position;
+    }
+
+    /**
+     * Returns the normal of a vertex.
+     * @param index The index of the vertex.
+     * @return The normal of the vertex.
      */
-    std::size_t size() const override
+    const Vector3f& getNormal(std::size_t index) const override
     {
-      return count * VertexType::size;
+      return vertices[index].normal;
+    }
+
+    /**
+     * Returns the texture coordinates of a vertex.
+     * @param index The index of the vertex.
+     * @return The texture coordinates of the vertex or \c nullptr if the vertex type does not have any.
+     */
+    const Vector2f* getTextureCoordinates(std::size_t index) const override
+    {
+      if constexpr(std::is_same_v<VertexType, VertexPNT>)
+        return &vertices[index].textureCoordinates;
+      else
+        return nullptr;
+    }
+
+    /** Frees the vertices in their original format (after they have been packed into \c packedData). */
+    void releaseVertices() override
+    {
+      std::vector<VertexType>().swap(vertices);
     }
   };
 
@@ -183,9 +248,21 @@ public:
   struct Mesh final
   {
   private:
+    /**
+     * A simplified version of a mesh that shares its vertex buffer.
+     */
+    struct LOD
+    {
+      const IndexBuffer* indexBuffer; /**< The triangles of this level of detail. */
+      float error; /**< The maximum distance (in m) by which vertices have been moved. */
+    };
+
     GLenum mode = GL_TRIANGLES; /**< The primitive type of this mesh. */
     const VertexBufferBase* vertexBuffer = nullptr; /**< The vertex buffer of this mesh. */
     const IndexBuffer* indexBuffer = nullptr; /**< The (optional) index buffer of this mesh. */
+    std::vector<LOD> lods; /**< Simplified versions of large meshes, ordered by increasing error. */
+    Vector3f center = Vector3f::Zero(); /**< The center of the bounding sphere (only set if there are LODs). */
+    float radius = 0.f; /**< The radius of the bounding sphere (only set if there are LODs). */
 
     friend class GraphicsContext;
   };
@@ -197,15 +274,33 @@ public:
   {
   private:
     /**
-     * Loads a texture.
+     * Loads a texture. Decoded images are cached on disk in the format in which they are uploaded.
      * @param file Path to the texture file.
      */
     Texture(const std::string& file);
 
+    /**
+     * Loads the texture from the cache.
+     * @param cacheFileName The name of the cache file.
+     * @param sourcePath The UTF-8 encoded absolute path of the texture file.
+     * @param lastModified The modification time of the texture file.
+     * @return Whether the cache file existed and belonged to this version of the texture file.
+     */
+    bool loadFromCache(const QString& cacheFileName, const QByteArray& sourcePath, qint64 lastModified);
+
+    /**
+     * Writes the texture to the cache.
+     * @param cacheFileName The name of the cache file.
+     * @param sourcePath The UTF-8 encoded absolute path of the texture file.
+     * @param lastModified The modification time of the texture file.
+     */
+    void saveToCache(const QString& cacheFileName, const QByteArray& sourcePath, qint64 lastModified) const;
+
     /* Destructor. Frees texture memory. */
     ~Texture();
 
     GLubyte* data = nullptr; /**< The raw texture data. */
+    std::size_t size = 0; /**< The size of \c data in bytes. */
     GLsizei width = 0; /**< The width of the texture in pixels. */
     GLsizei height = 0; /**< The height of the texture in pixels. */
     bool hasAlpha = false; /**< Whether the texture has an alpha channel. */
@@ -280,6 +375,12 @@ public:
    */
   void compile();
 
+  /**
+   * Returns the size of the vertex and index data that is uploaded to the GPU. Only valid after \c compile.
+   * @return The size in bytes.
+   */
+  std::size_t getBufferMemorySize() const {return vertexBufferTotalSize + indexBufferTotalSize;}
+
   /** Create per context data for the current context (which may include uploading data to the GPU). */
   void createGraphics();
 
@@ -321,6 +422,13 @@ public:
    */
   Mesh* requestMesh(const VertexBufferBase* vertexBuffer, const IndexBuffer* indexBuffer, PrimitiveTopology primitiveTopology);
 
+  /**
+   * Starts decoding a texture in the background, so that a later \c requestTexture
+   * for the same file does not have to wait for it.
+   * @param file The path to the texture file.
+   */
+  void preloadTexture(const std::string& file);
+
   /**
    * Requests a texture from a given file.
    * @param file The path to the texture file.
@@ -393,11 +501,14 @@ public:
    */
   void updateModelMatrices(ModelMatrix::Usage usage, bool forceUpdate);
 
+  /** Forces all model matrices to be updated the next time \c updateModelMatrices is called (e.g. because poses were interpolated). */
+  void invalidateModelMatrices();
+
   /**
    * Starts a color render pass.
    * @param projection The projection matrix of the camera.
    * @param view The view matrix (= inverse pose) of the camera.
-   * @param viewportX Lower left corner of the viewport. If negative, the viewport is not set.
+   * @param viewportX Lower left corner of the viewport. If negative, the viewport is not set (the current one is used to select levels of detail).
    * @param viewportY Lower left corner of the viewport.
    * @param viewportWidth Width of the viewport.
    * @param viewportHeight Height of the viewport.
@@ -417,6 +528,7 @@ public:
 
   /**
    * Draws a mesh with a given transformation and surface.
+   * Large meshes are drawn in the coarsest level of detail whose error is not visible at their projected size.
    * @param mesh The mesh to draw.
    * @param modelMatrix The model matrix representing the transformation of the mesh.
    * @param surface The surface to use (ignored if a forced surface has been set).
@@ -475,6 +587,8 @@ private:
     GLint cameraPosLocation = -1; /**< The location of the cameraPos uniform in the program. */
     GLint modelMatrixLocation = -1; /**< The location of the modelMatrix uniform in the program. */
     GLint surfaceIndexLocation = -1; /**< The location of the surfaceIndex uniform in the program. */
+    GLint positionScaleLocation = -1; /**< The location of the positionScale uniform in the program. */
+    GLint positionOffsetLocation = -1; /**< The location of the positionOffset uniform in the program. */
   };
 
   /**
@@ -558,6 +672,77 @@ private:
    */
   GLuint compileShader(const std::vector<const char*>& vertexShaderSources, const std::vector<const char*>& fragmentShaderSources);
 
+  /**
+   * Determines the name of the file in which the binary of a shader program is cached.
+   * The name contains a hash of the driver identification and the source code.
+   * @param vertexShaderSources A list of source code fragments that are concatenated to form the vertex shader.
+   * @param fragmentShaderSources A list of source code fragments that are concatenated to form the fragment shader.
+   * @return The file name or an empty string if the driver cannot provide program binaries.
+   */
+  std::string getProgramBinaryFileName(const std::vector<const char*>& vertexShaderSources, const std::vector<const char*>& fragmentShaderSources) const;
+
+  /**
+   * Creates a shader program from a cached binary.
+   * @param fileName The name of the cache file.
+   * @return A shader ID or 0 if the cache file does not exist or the driver rejected it.
+   */
+  GLuint loadProgramBinary(const std::string& fileName) const;
+
+  /**
+   * Writes the binary of a linked shader program to the cache.
+   * @param program The shader ID.
+   * @param fileName The name of the cache file.
+   */
+  void saveProgramBinary(GLuint program, const std::string& fileName) const;
+
+  /**
+   * Packs the vertices of a buffer into one of the compact vertex categories: Normals are packed
+   * into 10 bits per component, texture coordinates are converted to half floats and positions are
+   * quantized to 16 bits per component within their bounding box. Texture coordinates and positions
+   * are only converted if the loss of precision is acceptable.
+   * @param buffer The vertex buffer (still in the category of its vertex type).
+   * @return The index of the compact category or the index of the original category if texture coordinates cannot be packed.
+   */
+  std::size_t packVertexBuffer(VertexBufferBase& buffer) const;
+
+  /**
+   * Declares the vertex attributes of a compact vertex category in an OpenGL context (VAO and VBO are already bound).
+   * @tparam quantized Whether the positions are quantized.
+   * @tparam withTextureCoordinates Whether the vertices have texture coordinates.
+   * @param functions The OpenGL functions to use.
+   */
+  template<bool quantized, bool withTextureCoordinates>
+  static void setupPackedVertexAttributes(QOpenGLFunctions_3_3_Core& functions);
+
+  /**
+   * Returns the index of a compact vertex category.
+   * @param quantized Whether the positions are quantized.
+   * @param withTextureCoordinates Whether the vertices have texture coordinates.
+   * @return The index in \c vertexBuffers.
+   */
+  static constexpr std::size_t getPackedIndex(bool quantized, bool withTextureCoordinates)
+  {
+    return 2 + (quantized ? 2 : 0) + (withTextureCoordinates ? 1 : 0);
+  }
+
+  /**
+   * Returns the size of a vertex in a compact vertex category.
+   * @param quantized Whether the positions are quantized.
+   * @param withTextureCoordinates Whether the vertices have texture coordinates.
+   * @return The size in bytes.
+   */
+  static constexpr std::uint32_t getPackedSize(bool quantized, bool withTextureCoordinates)
+  {
+    return (quantized ? 8 : 12) + 4 + (withTextureCoordinates ? 4 : 0);
+  }
+
+  /**
+   * Generates simplified versions of a mesh by clustering its vertices on increasingly coarse grids.
+   * Only large indexed triangle meshes are simplified.
+   * @param mesh The mesh.
+   */
+  void createLODs(Mesh& mesh);
+
   /**
    * Compile a shader for color render passes.
    * @param lighting Whether lighting is enabled.
@@ -579,6 +764,7 @@ private:
 
   // Objects that are created during initialization (i.e. before the first call to \c createGraphics) but used throughout the runtime.
   std::unordered_map<std::string, Texture*> textures; /**< Map of filenames to textures. */
+  std::unordered_map<std::string, QFuture<Texture*>> preloadedTextures; /**< Map of filenames to textures that are decoded in the background. */
   std::array<ModelMatrixSet, ModelMatrix::numOfUsages> modelMatrixSets; /**< List of all registered model matrices. */
   std::vector<Surface*> surfaces; /**< List of all registered surfaces. */
   std::vector<VertexCategory> vertexBuffers; /**< List of the known vertex categories, pointing to all registered vertex buffers. */
@@ -602,6 +788,20 @@ private:
   // Only valid between \c startRendering and \c finishRendering:
   Shader* shader = nullptr; /**< The currently selected shader. */
   const Surface* forcedSurface = nullptr; /**< The surface which overrides \c draw's argument. */
+  bool positionsQuantized = false; /**< Whether the position dequantization uniforms are not the identity. */
+  Vector4f lodViewZ = Vector4f::Zero(); /**< The row of the view matrix that calculates the depth of a point. */
+  float lodScale = 0.f; /**< The number of pixels that 1 m covers at a depth of 1 m (perspective) or at any depth (orthographic). 0 disables LODs. */
+  bool lodPerspective = true; /**< Whether the projection is perspective, i.e. the projected size depends on the depth. */
+
+  // Compact vertex categories:
+  static constexpr float maxPositionError = 0.0001f; /**< The maximum error (in m) by which quantization may move a vertex along each axis. */
+  static constexpr float maxTextureCoordinateError = 1.f / 4096.f; /**< The maximum error of texture coordinates converted to half floats. */
+
+  // Levels of detail:
+  static constexpr std::size_t lodMinTriangles = 2048; /**< Meshes with fewer triangles are not simplified. */
+  static constexpr float viewLODError = 1.f; /**< The projected error (in pixels) that is acceptable in external rendering (i.e. in views). */
+  static constexpr float sensorLODError = 3.f; /**< The projected error (in pixels) that is acceptable in off-screen rendering (i.e. for sensors). */
+  float maxLODError = viewLODError; /**< The projected error (in pixels) that is acceptable in the current rendering. */
 
   // Offscreen rendering:
   QOpenGLContext* offscreenContext = nullptr; /**< The OpenGL context used for offscreen rendering. */
@@ -13,6 +13,7 @@
 #include "Simulation/Appearances/CapsuleAppearance.h"
 #include "Simulation/Appearances/ComplexAppearance.h"
 #include "Simulation/Appearances/CylinderAppearance.h"
+#include "Simulation/Appearances/MeshAppearance.h"
 #include "Simulation/Appearances/SphereAppearance.h"
 #include "Simulation/Axis.h"
 #include "Simulation/Body.h"
@@ -20,6 +21,7 @@
 #include "Simulation/Geometries/BoxGeometry.h"
 #include "Simulation/Geometries/CapsuleGeometry.h"
 #include "Simulation/Geometries/CylinderGeometry.h"
+#include "Simulation/Geometries/MeshGeometry.h"
 #include "Simulation/Geometries/SphereGeometry.h"
 #include "Simulation/Masses/BoxMass.h"
 #include "Simulation/Masses/CapsuleMass.h"
@@ -38,6 +40,9 @@
 #include "Simulation/Sensors/SingleDistanceSensor.h"
 #include "Simulation/Simulation.h"
 #include "Simulation/UserInput.h"
+#include <QFile>
+#include <QFileInfo>
+#include <cstring>
 
 ParserCore3::ParserCore3()
 {
@@ -97,6 +102,8 @@ ParserCore3::ParserCore3()
       0, translationClass | rotationClass | materialClass, setClass | geometryClass, {}},
     {"CapsuleGeometry", geometryClass, std::bind(&ParserCore3::capsuleGeometryElement, this), nullptr, 0,
       0, translationClass | rotationClass | materialClass, setClass | geometryClass, {}},
+    {"MeshGeometry", geometryClass, std::bind(&ParserCore3::meshGeometryElement, this), nullptr, 0,
+      verticesClass, translationClass | rotationClass | materialClass, setClass | geometryClass, {}},
 
     {"Material", materialClass, std::bind(&ParserCore3::materialElement, this), nullptr, constantFlag,
       0, 0, 0, {}},
@@ -114,16 +121,19 @@ ParserCore3::ParserCore3()
     {"ComplexAppearance", appearanceClass, std::bind(&ParserCore3::complexAppearanceElement, this), nullptr, 0,
       surfaceClass | verticesClass | primitiveGroupClass, translationClass | rotationClass | normalsClass | texCoordsClass, setClass | primitiveGroupClass | appearanceClass, {}},
 
+    {"MeshAppearance", appearanceClass, std::bind(&ParserCore3::meshAppearanceElement, this), nullptr, 0,
+      surfaceClass, translationClass | rotationClass, setClass | appearanceClass, {"file"}},
+
     {"Vertices", verticesClass, std::bind(&ParserCore3::verticesElement, this), std::bind(&ParserCore3::verticesText, this, _1, _2), textFlag | constantFlag,
-      0, 0, 0, {}},
+      0, 0, 0, {"file"}},
     {"Normals", normalsClass, std::bind(&ParserCore3::normalsElement, this), std::bind(&ParserCore3::normalsText, this, _1, _2), textFlag | constantFlag,
-      0, 0, 0, {}},
+      0, 0, 0, {"file"}},
     {"TexCoords", texCoordsClass, std::bind(&ParserCore3::texCoordsElement, this), std::bind(&ParserCore3::texCoordsText, this, _1, _2), textFlag | constantFlag,
-      0, 0, 0, {}},
+      0, 0, 0, {"file"}},
     {"Triangles", primitiveGroupClass, std::bind(&ParserCore3::trianglesElement, this), std::bind(&ParserCore3::trianglesAndQuadsText, this, _1, _2), textFlag | constantFlag,
-      0, 0, 0, {}},
+      0, 0, 0, {"file"}},
     {"Quads", primitiveGroupClass, std::bind(&ParserCore3::quadsElement, this), std::bind(&ParserCore3::trianglesAndQuadsText, this, _1, _2), textFlag | constantFlag,
-      0, 0, 0, {}},
+      0, 0, 0, {"file"}},
 
     {"Surface", surfaceClass, std::bind(&ParserCore3::surfaceElement, this), nullptr, constantFlag,
       0, 0, 0, {"diffuseTexture"}},
@@ -191,13 +201,64 @@ Element* ParserCore3::setElement()
   return nullptr;
 }
 
+void ParserCore3::getUpdateRate(Sensor& sensor)
+{
+  sensor.rate = getFloatPositive("rate", false, 0.f);
+  sensor.phase = getFloatMinMax("phase", false, 0.f, 0.f, 1.f);
+}
+
+template<typename T>
+void ParserCore3::readBinaryFile(std::vector<T>& values, bool affectsModel)
+{
+  const std::string& fileName = getString("file", false);
+  if(fileName.empty())
+    return;
+  const Location& location = attributes->find("file")->second.valueLocation;
+  QFile file(QString::fromStdString(fileName));
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    handleError("Could not open file \"" + fileName + "\"", location);
+    return;
+  }
+  if(affectsModel)
+    readFileNames.push_back(fileName); // the file is part of the scene (e.g. for the model cache)
+  const qint64 size = file.size();
+  if(size % sizeof(T))
+  {
+    handleError("Invalid file size (must be a multiple of " + std::to_string(sizeof(T)) + " bytes)", location);
+    return;
+  }
+
+  // Copy straight from the mapped file into the array (falling back to reading if it cannot be mapped).
+  const std::size_t offset = values.size();
+  values.resize(offset + static_cast<std::size_t>(size) / sizeof(T));
+  void* destination = static_cast<void*>(values.data() + offset);
+  if(const uchar* mapped = size ? file.map(0, size) : nullptr; mapped)
+    std::memcpy(destination, mapped, static_cast<std::size_t>(size));
+  else if(file.read(static_cast<char*>(destination), size) != size)
+  {
+    handleError("Could not read file \"" + fileName + "\"", location);
+    values.resize(offset);
+  }
+}
+
 Element* ParserCore3::sceneElement()
 {
   Scene* scene = new Scene();
   scene->name = getString("name", false);
   scene->controller = getString("controller", false);
+  const std::string& bridge = getString("bridge", false);
+  if(bridge == "lockstep")
+    scene->bridgeMode = ControllerBridge::lockstep;
+  else if(bridge == "freeRunning")
+    scene->bridgeMode = ControllerBridge::freeRunning;
+  else if(!bridge.empty() && bridge != "off")
+    handleError("Expected bridge mode (off, lockstep or freeRunning)", attributes->find("bridge")->second.valueLocation);
+  scene->bridgeTimeout = static_cast<unsigned int>(getInteger("bridgeTimeout", false, 1000, true));
   getColor("color", false, scene->color, true);
   scene->stepLength = getTimeNonZeroPositive("stepLength", false, 0.01f);
+  scene->realTimeFactor = getFloatPositive("realTimeFactor", false, 0.f);
+  scene->maxSubSteps = static_cast<unsigned int>(getInteger("maxSubSteps", false, 10, true));
   scene->gravity = getAcceleration("gravity", false, -9.80665f);
   scene->detectBodyCollisions = getBool("bodyCollisions", false, true);
 
@@ -397,6 +458,17 @@ Element* ParserCore3::capsuleGeometryElement()
   return capsuleGeometry;
 }
 
+Element* ParserCore3::meshGeometryElement()
+{
+  MeshGeometry* meshGeometry = new MeshGeometry();
+  getColor("color", false, meshGeometry->color, true);
+  meshGeometry->name = getString("name", false);
+  meshGeometry->maxVertices = getInteger("maxVertices", false, 0, false);
+  if(meshGeometry->maxVertices < 0 || (meshGeometry->maxVertices > 0 && meshGeometry->maxVertices < 4))
+    handleError("Expected 0 (unlimited) or at least 4 vertices", attributes->find("maxVertices")->second.valueLocation);
+  return meshGeometry;
+}
+
 Element* ParserCore3::materialElement()
 {
   Geometry::Material* material = new Geometry::Material();
@@ -455,16 +527,55 @@ Element* ParserCore3::complexAppearanceElement()
   return complexAppearance;
 }
 
+Element* ParserCore3::meshAppearanceElement()
+{
+  MeshAppearance* meshAppearance = new MeshAppearance();
+  meshAppearance->name = getString("name", false);
+  meshAppearance->file = getString("file", true);
+  meshAppearance->unit = getUnit("unit", false, 1);
+  if(!meshAppearance->file.empty())
+  {
+    const Location& location = attributes->find("file")->second.valueLocation;
+    if(MeshAppearance::getFormat(meshAppearance->file) == MeshAppearance::unknown)
+      handleError("Unsupported mesh file format (must be .stl, .ply or .obj)", location);
+    else if(!QFileInfo(QString::fromStdString(meshAppearance->file)).isReadable())
+      handleError("Could not open file \"" + meshAppearance->file + "\"", location);
+  }
+  return meshAppearance;
+}
+
 Element* ParserCore3::trianglesElement()
 {
-  return new ComplexAppearance::PrimitiveGroup(ComplexAppearance::triangles);
+  ComplexAppearance::PrimitiveGroup* primitiveGroup = new ComplexAppearance::PrimitiveGroup(ComplexAppearance::triangles);
+  readBinaryFile(primitiveGroup->vertices);
+  return primitiveGroup;
+}
+
+/**
+ * Counts the whitespace separated tokens in a text (including those in comments),
+ * which is an upper bound of the number of values it contains.
+ * @param text The text
+ * @return The number of tokens
+ */
+static std::size_t countTokens(const std::string& text)
+{
+  std::size_t count = 0;
+  bool inToken = false;
+  for(const char c : text)
+  {
+    const bool isSpace = c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    count += !isSpace && !inToken;
+    inToken = !isSpace;
+  }
+  return count;
 }
 
 void ParserCore3::trianglesAndQuadsText(std::string& text, Location location)
 {
   ComplexAppearance::PrimitiveGroup* primitiveGroup = dynamic_cast<ComplexAppearance::PrimitiveGroup*>(element);
   ASSERT(primitiveGroup);
-  std::list<unsigned int>& vs = primitiveGroup->vertices;
+  std::vector<unsigned int>& vs = primitiveGroup->vertices;
+  vs.reserve(vs.size() + countTokens(text));
   const char* str = text.c_str();
   char* nextStr;
   unsigned int l;
@@ -487,13 +598,18 @@ void ParserCore3::trianglesAndQuadsText(std::string& text, Location location)
 
 Element* ParserCore3::quadsElement()
 {
-  return new ComplexAppearance::PrimitiveGroup(ComplexAppearance::quads);
+  ComplexAppearance::PrimitiveGroup* primitiveGroup = new ComplexAppearance::PrimitiveGroup(ComplexAppearance::quads);
+  readBinaryFile(primitiveGroup->vertices);
+  return primitiveGroup;
 }
 
 Element* ParserCore3::verticesElement()
 {
   ComplexAppearance::Vertices* vertices = new ComplexAppearance::Vertices();
   vertices->unit = getUnit("unit", false, 1);
+  readBinaryFile(vertices->vertices, true);
+  for(Vector3f& vertex : vertices->vertices)
+    vertex *= vertices->unit;
   return vertices;
 }
 
@@ -502,6 +618,7 @@ void ParserCore3::verticesText(std::string& text, Location location)
   ComplexAppearance::Vertices* vertices = dynamic_cast<ComplexAppearance::Vertices*>(element);
   ASSERT(vertices);
   std::vector<Vector3f>& vs = vertices->vertices;
+  vs.reserve(vs.size() + countTokens(text) / 3);
   const char* str = text.c_str();
   char* nextStr;
   float components[3];
@@ -530,7 +647,9 @@ void ParserCore3::verticesText(std::string& text, Location location)
 
 Element* ParserCore3::normalsElement()
 {
-  return new ComplexAppearance::Normals();
+  ComplexAppearance::Normals* normals = new ComplexAppearance::Normals();
+  readBinaryFile(normals->normals);
+  return normals;
 }
 
 void ParserCore3::normalsText(std::string& text, Location location)
@@ -538,6 +657,7 @@ void ParserCore3::normalsText(std::string& text, Location location)
   ComplexAppearance::Normals* normals = dynamic_cast<ComplexAppearance::Normals*>(element);
   ASSERT(normals);
   std::vector<Vector3f>& ns = normals->normals;
+  ns.reserve(ns.size() + countTokens(text) / 3);
   const char* str = text.c_str();
   char* nextStr;
   float components[3];
@@ -563,7 +683,9 @@ void ParserCore3::normalsText(std::string& text, Location location)
 
 Element* ParserCore3::texCoordsElement()
 {
-  return new ComplexAppearance::TexCoords();
+  ComplexAppearance::TexCoords* texCoords = new ComplexAppearance::TexCoords();
+  readBinaryFile(texCoords->coords);
+  return texCoords;
 }
 
 void ParserCore3::texCoordsText(std::string& text, Location location)
@@ -571,6 +693,7 @@ void ParserCore3::texCoordsText(std::string& text, Location location)
   ComplexAppearance::TexCoords* texCoords = dynamic_cast<ComplexAppearance::TexCoords*>(element);
   ASSERT(texCoords);
   std::vector<Vector2f>& ts = texCoords->coords;
+  ts.reserve(ts.size() + countTokens(text) / 2);
   const char* str = text.c_str();
   char* nextStr;
   float components[2];
@@ -732,6 +855,8 @@ Element* ParserCore3::surfaceElement()
   surface->roughness = getFloatMinMax("roughness", false, surface->roughness, 0.f, 1.f);
   surface->ambient = getFloatMinMax("ambient", false, surface->ambient, 0.f, 1.f);
   surface->texturePath = getString("texture", false);
+  if(!surface->texturePath.empty())
+    Simulation::simulation->graphicsContext.preloadTexture(surface->texturePath); // decode while the rest of the scene is loaded
   return surface;
 }
 
@@ -739,6 +864,7 @@ Element* ParserCore3::gyroscopeElement()
 {
   Gyroscope* gyroscope = new Gyroscope();
   gyroscope->name = getString("name", false);
+  getUpdateRate(*gyroscope);
   return gyroscope;
 }
 
@@ -746,6 +872,7 @@ Element* ParserCore3::accelerometerElement()
 {
   Accelerometer* accelerometer = new Accelerometer();
   accelerometer->name = getString("name", false);
+  getUpdateRate(*accelerometer);
   return accelerometer;
 }
 
@@ -757,6 +884,7 @@ Element* ParserCore3::cameraElement()
   camera->imageHeight = getInteger("imageHeight", true, 0, true);
   camera->angleX = getAngle("angleX", true, 0.f, true);
   camera->angleY = getAngle("angleY", true, 0.f, true);
+  getUpdateRate(*camera);
   return camera;
 }
 
@@ -764,6 +892,7 @@ Element* ParserCore3::collisionSensorElement()
 {
   CollisionSensor* collisionSensor = new CollisionSensor();
   collisionSensor->name = getString("name", false);
+  getUpdateRate(*collisionSensor);
   return collisionSensor;
 }
 
@@ -775,6 +904,7 @@ Element* ParserCore3::objectSegmentedImageSensorElement()
   camera->imageHeight = getInteger("imageHeight", true, 0, true);
   camera->angleX = getAngle("angleX", true, 0.f, true);
   camera->angleY = getAngle("angleY", true, 0.f, true);
+  getUpdateRate(*camera);
   return camera;
 }
 
@@ -784,6 +914,7 @@ Element* ParserCore3::singleDistanceSensorElement()
   singleDistanceSensor->name = getString("name", false);
   singleDistanceSensor->min = getLength("min", false, 0.f, false);
   singleDistanceSensor->max = getLength("max", false, 999999.f, false);
+  getUpdateRate(*singleDistanceSensor);
   return singleDistanceSensor;
 }
 
@@ -813,6 +944,7 @@ Element* ParserCore3::depthImageSensorElement()
     handleError("Unexpected projection type \"" + projection + "\" (expected one of \"perspective, spherical\")",
                 attributes->find("projection")->second.valueLocation);
 
+  getUpdateRate(*depthImageSensor);
   return depthImageSensor;
 }
 
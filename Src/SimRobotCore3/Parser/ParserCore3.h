@@ -11,6 +11,7 @@
 #include <vector>
 
 class Element;
+class Sensor;
 
 /**
  * @class ParserCore3
@@ -52,6 +53,23 @@ private:
 
   bool getColor(const char* key, bool required, float* colors, bool withAlpha);
 
+  /**
+   * Reads the optional attributes "rate" (in Hz) and "phase" (as fraction of the update period) of a sensor element
+   * @param sensor The sensor
+   */
+  void getUpdateRate(Sensor& sensor);
+
+  /**
+   * Appends the contents of the binary file referenced by the optional attribute "file" to an array.
+   * The file contains the raw values in native byte order without any header.
+   * @tparam T The type of the array elements
+   * @param values The array
+   * @param affectsModel Whether the values can be part of the compiled model (i.e. vertices, which mesh geometries
+   *                     use), so that the file must be part of the key of the model cache
+   */
+  template<typename T>
+  void readBinaryFile(std::vector<T>& values, bool affectsModel = false);
+
   Element* sceneElement();
   Element* setElement();
   Element* compoundElement();
@@ -69,6 +87,7 @@ private:
   Element* sphereGeometryElement();
   Element* cylinderGeometryElement();
   Element* capsuleGeometryElement();
+  Element* meshGeometryElement();
   Element* materialElement();
   Element* appearanceElement();
   Element* boxAppearanceElement();
@@ -76,6 +95,7 @@ private:
   Element* cylinderAppearanceElement();
   Element* capsuleAppearanceElement();
   Element* complexAppearanceElement();
+  Element* meshAppearanceElement();
   Element* trianglesElement();
   Element* quadsElement();
   void trianglesAndQuadsText(std::string& text, Location location);
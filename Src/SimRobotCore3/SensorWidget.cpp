@@ -13,6 +13,7 @@
 #include <QLocale>
 #include <QMenu>
 #include <QMimeData>
+#include <array>
 #include <iomanip>
 #include <sstream>
 
@@ -80,21 +81,7 @@ void SensorWidget::paintEvent(QPaintEvent*)
     }
     case SimRobotCore3::SensorPort::cameraSensor:
     {
-      int xSize = dimensions[0], ySize = dimensions[1];
-      const unsigned char* vals = sensor->getValue().byteArray;
-      unsigned char* buffer = new unsigned char[xSize * ySize * 4];
-      unsigned char* pDest = buffer;
-      for(int y = ySize - 1; y >= 0; --y)
-        for(const unsigned char* pSrc = vals + xSize * 3 * y, * end = pSrc + xSize * 3; pSrc < end; pSrc += 3)
-        {
-          *pDest++ = pSrc[2];
-          *pDest++ = pSrc[1];
-          *pDest++ = pSrc[0];
-          *pDest++ = 0xff;
-        }
-      QImage img(buffer, xSize, ySize, QImage::Format_RGB32);
-      painter.drawImage(0, 0, img.scaled(this->width(), this->height()));
-      delete [] buffer;
+      paintCameraSensor();
       break;
     }
     case SimRobotCore3::SensorPort::noSensor:
@@ -159,67 +146,80 @@ void SensorWidget::paintFloatArrayWithLimitsAndWithoutDescriptions()
   }
 }
 
-void SensorWidget::paint2DFloatArrayWithLimitsAndWithoutDescriptions()
+void SensorWidget::paintCameraSensor()
 {
-  float minValue, maxValue;
-  if(!sensor->getMinAndMax(minValue, maxValue))
+  if(prepareImage())
   {
-    minValue = 0;
-    maxValue = 1;
+    // The rows are flipped, because OpenGL images start at the bottom.
+    const int xSize = sensorDimensions[0], ySize = sensorDimensions[1];
+    const unsigned char* vals = sensor->getValue().byteArray;
+    for(int y = 0; y < ySize; ++y)
+    {
+      const unsigned char* pSrc = vals + xSize * 3 * (ySize - 1 - y);
+      QRgb* pDest = reinterpret_cast<QRgb*>(image.scanLine(y));
+      for(int x = 0; x < xSize; ++x, pSrc += 3)
+        pDest[x] = 0xff000000u | pSrc[0] << 16 | pSrc[1] << 8 | pSrc[2];
+    }
   }
-  double scale = (6 << 8) / (maxValue - minValue);
-  int xSize = sensorDimensions[0], ySize = sensorDimensions[1];
-  const float* vals = sensor->getValue().floatArray;
-  unsigned char* buffer = new unsigned char[xSize * ySize * 4];
-  unsigned char* pDest = buffer;
-  for(int y = ySize - 1; y >= 0; --y)
-    for(const float* pSrc = vals + xSize * y, * end = pSrc + xSize; pSrc < end; ++pSrc)
+  painter.drawImage(rect(), image);
+}
+
+void SensorWidget::paint2DFloatArrayWithLimitsAndWithoutDescriptions()
+{
+  // A color map from white over blue, cyan, green, yellow and red to black, plus black for values out of range
+  static const std::array<QRgb, (6 << 8) + 1> colorMap = []
+  {
+    std::array<QRgb, (6 << 8) + 1> colorMap;
+    for(int i = 0; i < 256; ++i)
     {
-      unsigned value = unsigned((*pSrc - minValue) * scale);
-      unsigned char c = static_cast<unsigned char>(value);
-      switch(value >> 8)
+      colorMap[i] = qRgb(255 - i, 255 - i, 255);
+      colorMap[256 + i] = qRgb(0, i, 255);
+      colorMap[512 + i] = qRgb(0, 255, 255 - i);
+      colorMap[768 + i] = qRgb(i, 255, 0);
+      colorMap[1024 + i] = qRgb(255, 255 - i, 0);
+      colorMap[1280 + i] = qRgb(255 - i, 0, 0);
+    }
+    colorMap[6 << 8] = qRgb(0, 0, 0);
+    return colorMap;
+  }();
+
+  if(prepareImage())
+  {
+    float minValue, maxValue;
+    if(!sensor->getMinAndMax(minValue, maxValue))
+    {
+      minValue = 0;
+      maxValue = 1;
+    }
+    const float scale = (6 << 8) / (maxValue - minValue);
+    const int xSize = sensorDimensions[0], ySize = sensorDimensions[1];
+    const float* vals = sensor->getValue().floatArray;
+    for(int y = 0; y < ySize; ++y)
+    {
+      const float* pSrc = vals + xSize * (ySize - 1 - y);
+      QRgb* pDest = reinterpret_cast<QRgb*>(image.scanLine(y));
+      for(int x = 0; x < xSize; ++x)
       {
-        case 0:
-          *pDest++ = 255;
-          *pDest++ = 255 - c;
-          *pDest++ = 255 - c;
-          break;
-        case 1:
-          *pDest++ = 255;
-          *pDest++ = c;
-          *pDest++ = 0;
-          break;
-        case 2:
-          *pDest++ = 255 - c;
-          *pDest++ = 255;
-          *pDest++ = 0;
-          break;
-        case 3:
-          *pDest++ = 0;
-          *pDest++ = 255;
-          *pDest++ = c;
-          break;
-        case 4:
-          *pDest++ = 0;
-          *pDest++ = 255 - c;
-          *pDest++ = 255;
-          break;
-        case 5:
-          *pDest++ = 0;
-          *pDest++ = 0;
-          *pDest++ = 255 - c;
-          break;
-        default:
-          *pDest++ = 0;
-          *pDest++ = 0;
-          *pDest++ = 0;
-          break;
+        const float value = (pSrc[x] - minValue) * scale;
+        pDest[x] = colorMap[value >= 0.f && value < static_cast<float>(6 << 8) ? static_cast<int>(value) : 6 << 8];
       }
-      *pDest++ = 0xff;
     }
-  QImage img(buffer, xSize, ySize, QImage::Format_RGB32);
-  painter.drawImage(0, 0, img.scaled(this->width(), this->height()));
-  delete [] buffer;
+  }
+  painter.drawImage(rect(), image);
+}
+
+bool SensorWidget::prepareImage()
+{
+  const QSize size(sensorDimensions[0], sensorDimensions[1]);
+  if(image.size() != size)
+  {
+    image = QImage(size, QImage::Format_RGB32);
+    imageStep = 0xffffffff;
+  }
+  if(imageStep == Simulation::simulation->simulationStep)
+    return false;
+  imageStep = Simulation::simulation->simulationStep;
+  return true;
 }
 
 QSize SensorWidget::sizeHint() const
@@ -231,6 +231,10 @@ QSize SensorWidget::sizeHint() const
 
 void SensorWidget::update()
 {
+  // The readings only change from one step to the next, so there is nothing new to paint otherwise.
+  if(Simulation::simulation->simulationStep == lastSimulationStep)
+    return;
+  lastSimulationStep = Simulation::simulation->simulationStep;
   QWidget::update();
 }
 
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "SimRobotCore3.h"
+#include <QImage>
 #include <QList>
 #include <QPainter>
 #include <QPen>
@@ -36,6 +37,9 @@ private:
   SimRobotCore3::SensorPort* sensor;
   SimRobotCore3::SensorPort::SensorType sensorType;
   QList<int> sensorDimensions;
+  QImage image; /**< The image of a camera or depth sensor (reused between repaints) */
+  unsigned int imageStep = 0xffffffff; /**< The simulation step of the readings in \c image */
+  unsigned int lastSimulationStep = 0xffffffff; /**< The simulation step in which a repaint was requested the last time */
 
   QWidget* getWidget() override {return this;}
   void update() override;
@@ -47,8 +51,15 @@ private:
   void paintBoolSensor();
   void paintFloatArrayWithDescriptionsSensor();
   void paintFloatArrayWithLimitsAndWithoutDescriptions();
+  void paintCameraSensor();
   void paint2DFloatArrayWithLimitsAndWithoutDescriptions();
 
+  /**
+   * Prepares \c image for the current readings
+   * @return Whether the image has to be filled, i.e. it does not contain the current readings yet
+   */
+  bool prepareImage();
+
   void setClipboardGraphics(QMimeData& mimeData);
   void setClipboardText(QMimeData& mimeData);
 
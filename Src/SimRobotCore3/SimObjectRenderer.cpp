@@ -69,10 +69,47 @@ void SimObjectRenderer::destroy()
   }
 }
 
+bool SimObjectRenderer::ViewState::operator==(const ViewState& other) const
+{
+  return simulationStep == other.simulationStep && renderInterpolation == other.renderInterpolation && poseChanges == other.poseChanges
+         && cameraPos == other.cameraPos && cameraTarget == other.cameraTarget && fovY == other.fovY
+         && width == other.width && height == other.height && renderFlags == other.renderFlags
+         && surfaceShadeMode == other.surfaceShadeMode && physicsShadeMode == other.physicsShadeMode
+         && drawingsShadeMode == other.drawingsShadeMode && dragging == other.dragging && dragPlane == other.dragPlane;
+}
+
+SimObjectRenderer::ViewState SimObjectRenderer::getViewState() const
+{
+  ViewState state;
+  state.simulationStep = Simulation::simulation->simulationStep;
+  state.renderInterpolation = Simulation::simulation->renderInterpolation;
+  state.poseChanges = Simulation::simulation->scene->poseChanges;
+  state.cameraPos = cameraPos;
+  state.cameraTarget = cameraTarget;
+  state.fovY = fovY;
+  state.width = width;
+  state.height = height;
+  state.renderFlags = renderFlags;
+  state.surfaceShadeMode = surfaceShadeMode;
+  state.physicsShadeMode = physicsShadeMode;
+  state.drawingsShadeMode = drawingsShadeMode;
+  state.dragging = dragging;
+  state.dragPlane = dragPlane;
+  return state;
+}
+
+bool SimObjectRenderer::needsRedraw() const
+{
+  // While dragging, the object follows the mouse even if nothing else changes.
+  return dragging || !(getViewState() == drawnState);
+}
+
 void SimObjectRenderer::draw()
 {
-  // make sure transformations of movable bodies are up-to-date
-  Simulation::simulation->scene->updateTransformations();
+  drawnState = getViewState();
+
+  // make sure transformations of movable bodies are up-to-date (and between the last two steps if the simulation runs in real time)
+  Simulation::simulation->scene->updateTransformations(Simulation::simulation->renderInterpolation);
 
   if(dragging && dragSelection)
   {
@@ -115,15 +152,16 @@ void SimObjectRenderer::draw()
   const bool drawCoordinateSystem = renderFlags & showCoordinateSystem;
   const bool drawControllerDrawings = (physicalObject || graphicalObject) && drawingsShadeMode != noShading && Simulation::simulation->scene->drawingManager;
 
+  // The model matrices are shared by all renderers and sensors and only updated once per step (or change of the poses).
   GraphicsContext& graphicsContext = Simulation::simulation->graphicsContext;
   if(drawAppearances || drawControllerDrawings)
-    graphicsContext.updateModelMatrices(GraphicsContext::ModelMatrix::appearance, dragging && dragSelection);
+    graphicsContext.updateModelMatrices(GraphicsContext::ModelMatrix::appearance, false);
   if(drawPhysics || drawControllerDrawings)
-    graphicsContext.updateModelMatrices(GraphicsContext::ModelMatrix::physicalDrawing, dragging && dragSelection);
+    graphicsContext.updateModelMatrices(GraphicsContext::ModelMatrix::physicalDrawing, false);
   if(drawSensors || drawControllerDrawings)
-    graphicsContext.updateModelMatrices(GraphicsContext::ModelMatrix::sensorDrawing, dragging && dragSelection);
+    graphicsContext.updateModelMatrices(GraphicsContext::ModelMatrix::sensorDrawing, false);
   if(drawControllerDrawings)
-    graphicsContext.updateModelMatrices(GraphicsContext::ModelMatrix::controllerDrawing, dragging && dragSelection);
+    graphicsContext.updateModelMatrices(GraphicsContext::ModelMatrix::controllerDrawing, false);
   if(drawDragPlane)
     graphicsContext.updateModelMatrices(GraphicsContext::ModelMatrix::dragPlane, true);
 
@@ -60,6 +60,39 @@ private:
   unsigned int dragStartTime;
   static constexpr int degreeSteps = 15;
 
+  /** Everything that determines what a view shows, except for the scene itself */
+  struct ViewState
+  {
+    unsigned int simulationStep = 0xffffffff; /**< The simulation step */
+    float renderInterpolation = 1.f; /**< Where bodies are drawn between the previous and the current step */
+    unsigned int poseChanges = 0; /**< The number of times poses changed without a simulation step */
+    Vector3f cameraPos = Vector3f::Zero(); /**< The position of the camera */
+    Vector3f cameraTarget = Vector3f::Zero(); /**< The point the camera looks at */
+    float fovY = 0.f; /**< The vertical opening angle */
+    unsigned int width = 0; /**< The width of the view */
+    unsigned int height = 0; /**< The height of the view */
+    unsigned int renderFlags = 0; /**< The render flags */
+    ShadeMode surfaceShadeMode = noShading; /**< How appearances are drawn */
+    ShadeMode physicsShadeMode = noShading; /**< How physical representations are drawn */
+    ShadeMode drawingsShadeMode = noShading; /**< How controller drawings are drawn */
+    bool dragging = false; /**< Whether something is dragged */
+    DragAndDropPlane dragPlane = xyPlane; /**< The plane in which objects are dragged */
+
+    /**
+     * Compares two view states
+     * @param other The other view state
+     * @return Whether both states show the same
+     */
+    bool operator==(const ViewState& other) const;
+  };
+  ViewState drawnState; /**< The state of the view when it was drawn the last time */
+
+  /**
+   * Determines the current state of the view
+   * @return The state
+   */
+  ViewState getViewState() const;
+
   void updateCameraTransformation();
 
   bool intersectRayAndPlane(const Vector3f& point, const Vector3f& v,
@@ -76,6 +109,7 @@ public:
   void init() override;
   void destroy() override;
   void draw() override;
+  bool needsRedraw() const override;
   void resize(float fovY, unsigned int width, unsigned int height) override;
   void getSize(unsigned int& width, unsigned int& height) const override;
   void setSurfaceShadeMode(ShadeMode shadeMode) override {surfaceShadeMode = shadeMode;}
@@ -302,7 +302,9 @@ void SimObjectWidget::wheelEvent(QWheelEvent* event)
 
 void SimObjectWidget::update()
 {
-  QOpenGLWidget::update();
+  // Only views that would look different are drawn again, so the cost does not grow with the number of views.
+  if(objectRenderer.needsRedraw())
+    QOpenGLWidget::update();
 }
 
 QMenu* SimObjectWidget::createEditMenu() const
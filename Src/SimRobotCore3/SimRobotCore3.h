@@ -25,6 +25,8 @@ namespace SimRobotCore3
   class Sensor;
   class Compound;
   class Scene;
+  class SensorGroup;
+  class ActuatorGroup;
   class SensorPort;
   class ActuatorPort;
 
@@ -120,6 +122,13 @@ namespace SimRobotCore3
     /** Draws the scene object on the currently selected OpenGL context. */
     virtual void draw() = 0;
 
+    /**
+     * Returns whether \c draw would produce a different image than the last time, because the simulation advanced
+     * or the camera, the render settings or the drag state changed.
+     * @return Whether the object has to be drawn again
+     */
+    virtual bool needsRedraw() const = 0;
+
     /**
      * Sets the size of the currently selected OpenGL renderer device. Call this once at the beginning to initialize the size.
      * @param width The width of the renderer device
@@ -552,6 +561,138 @@ namespace SimRobotCore3
      * @return True if no manager was already registered
      */
     virtual bool registerDrawingManager(Controller3DDrawingManager& manager) = 0;
+
+    /**
+     * Creates a group of sensors whose readings can be read into a single buffer at once.
+     * This is considerably faster than calling \c SensorPort::getValue for each sensor.
+     * @param sensors The sensors of the group (must not contain camera sensors)
+     * @param count The number of sensors
+     * @return The group (must be deleted by the caller) or \c nullptr if a sensor is not supported
+     */
+    virtual SensorGroup* createSensorGroup(SensorPort* const* sensors, unsigned int count) = 0;
+
+    /**
+     * Creates a group of actuators whose setpoints can be set from a single buffer at once.
+     * @param actuators The actuators of the group
+     * @param count The number of actuators
+     * @return The group (must be deleted by the caller)
+     */
+    virtual ActuatorGroup* createActuatorGroup(ActuatorPort* const* actuators, unsigned int count) = 0;
+
+    /**
+     * Finds the root bodies whose geometries (approximately) overlap an axis-aligned box.
+     * @param min The minimum corner of the box (x, y, z)
+     * @param max The maximum corner of the box (x, y, z)
+     * @param bodies Is filled with the root bodies found
+     */
+    virtual void queryAABB(const float* min, const float* max, QList<Body*>& bodies) = 0;
+
+    /**
+     * Finds the root bodies whose positions are within a sphere. Only bodies with geometries are found.
+     * @param center The center of the sphere (x, y, z)
+     * @param radius The radius of the sphere
+     * @param bodies Is filled with the root bodies found
+     */
+    virtual void queryRadius(const float* center, float radius, QList<Body*>& bodies) = 0;
+
+    /**
+     * Finds the root bodies whose positions are closest to a point. Only bodies with geometries are found.
+     * @param point The point (x, y, z)
+     * @param count The maximum number of bodies to find
+     * @param bodies Is filled with the root bodies found, sorted by increasing distance
+     */
+    virtual void queryNearest(const float* point, unsigned int count, QList<Body*>& bodies) = 0;
+
+    /**
+     * Finds the first geometry that is hit by a ray.
+     * @param origin The start of the ray (x, y, z)
+     * @param direction The direction of the ray (x, y, z, does not need to be normalized)
+     * @param maxDistance The maximum length of the ray
+     * @param distance Is set to the distance to the hit, if not \c nullptr and something was hit
+     * @return The root body that was hit or \c nullptr if nothing or a static geometry was hit
+     */
+    virtual Body* queryRay(const float* origin, const float* direction, float maxDistance, float* distance = nullptr) = 0;
+
+    /**
+     * Starts writing the state after each simulation step to a compressed log, beginning with the current state.
+     * The log contains the poses of all bodies, the joint positions and velocities and the readings of the
+     * sensors that are computed by MuJoCo (accelerometers and gyroscopes).
+     * @param fileName The name of the log file
+     * @return Whether the file could be created
+     */
+    virtual bool startRecording(const QString& fileName) = 0;
+
+    /** Stops writing the log and completes the file */
+    virtual void stopRecording() = 0;
+
+    /**
+     * Starts replaying a log recorded from this scene. Instead of simulating, each step then advances to the
+     * next state in the log.
+     * @param fileName The name of the log file
+     * @return Whether the file is a log of a scene with the same structure
+     */
+    virtual bool startReplay(const QString& fileName) = 0;
+
+    /** Stops replaying, i.e. the simulation continues from the state replayed last */
+    virtual void stopReplay() = 0;
+
+    /**
+     * Jumps to a state in the replayed log
+     * @param frame The index of the state in the log
+     * @return Whether a log is replayed and contains the state
+     */
+    virtual bool seekReplay(unsigned int frame) = 0;
+
+    /**
+     * Returns the number of states in the replayed log
+     * @return The number of states or 0 if no log is replayed
+     */
+    virtual unsigned int getReplayLength() const = 0;
+  };
+
+  /**
+   * @class SensorGroup
+   * A set of sensors that are read together into a contiguous buffer
+   */
+  class SensorGroup
+  {
+  public:
+    virtual ~SensorGroup() = default;
+
+    /**
+     * Returns the number of values \c read writes, i.e. the sum of the numbers of readings of all sensors
+     * @return The number of values
+     */
+    virtual unsigned int getSize() const = 0;
+
+    /**
+     * Writes the current readings of all sensors in the order they were passed to \c Scene::createSensorGroup.
+     * Boolean readings are written as 0 or 1.
+     * @param values A buffer for \c getSize values
+     */
+    virtual void read(float* values) = 0;
+  };
+
+  /**
+   * @class ActuatorGroup
+   * A set of actuators whose setpoints are set together from a contiguous buffer
+   */
+  class ActuatorGroup
+  {
+  public:
+    virtual ~ActuatorGroup() = default;
+
+    /**
+     * Returns the number of actuators in the group
+     * @return The number of actuators
+     */
+    virtual unsigned int getSize() const = 0;
+
+    /**
+     * Sets the setpoints of all actuators, which is equivalent to calling \c ActuatorPort::setValue for each of them
+     * @param values One value per actuator in the order they were passed to \c Scene::createActuatorGroup
+     */
+    virtual void setValues(const float* values) = 0;
   };
 
   /**
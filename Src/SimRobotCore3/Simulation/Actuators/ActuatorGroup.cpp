@@ -0,0 +1,38 @@
+/**
+ * @file Simulation/Actuators/ActuatorGroup.cpp
+ * Implementation of class ActuatorGroup
+ */
+
+#include "ActuatorGroup.h"
+#include "Simulation/Motors/ServoMotor.h"
+#include "Simulation/Scene.h"
+#include "Simulation/Simulation.h"
+#include <algorithm>
+
+ActuatorGroup::ActuatorGroup(SimRobotCore3::ActuatorPort* const* actuators, unsigned int count) :
+  size(count)
+{
+  for(unsigned int i = 0; i < count; ++i)
+    if(const ServoMotor* servoMotor = dynamic_cast<const ServoMotor*>(actuators[i]); servoMotor)
+    {
+      servoMotorIndices.push_back(servoMotor->bankIndex);
+      servoMotorOffsets.push_back(i);
+    }
+    else
+    {
+      ports.push_back(actuators[i]);
+      portOffsets.push_back(i);
+    }
+}
+
+void ActuatorGroup::setValues(const float* values)
+{
+  ServoMotorBank& bank = Simulation::simulation->scene->servoMotors;
+  for(std::size_t i = 0, count = servoMotorIndices.size(); i < count; ++i)
+  {
+    const unsigned int index = servoMotorIndices[i];
+    bank.targets[index] = std::clamp(values[servoMotorOffsets[i]], bank.minTargets[index], bank.maxTargets[index]);
+  }
+  for(std::size_t i = 0, count = ports.size(); i < count; ++i)
+    ports[i]->setValue(values[portOffsets[i]]);
+}
@@ -0,0 +1,37 @@
+/**
+ * @file Simulation/Actuators/ActuatorGroup.h
+ * Declaration of class ActuatorGroup
+ */
+
+#pragma once
+
+#include "SimRobotCore3.h"
+#include <vector>
+
+/**
+ * @class ActuatorGroup
+ * A set of actuators whose setpoints are set together. The setpoints of servo motors
+ * are written directly into the scene's \c ServoMotorBank. All other actuators are set
+ * through \c ActuatorPort::setValue.
+ */
+class ActuatorGroup : public SimRobotCore3::ActuatorGroup
+{
+public:
+  /**
+   * Constructor
+   * @param actuators The actuators of the group
+   * @param count The number of actuators
+   */
+  ActuatorGroup(SimRobotCore3::ActuatorPort* const* actuators, unsigned int count);
+
+private:
+  std::vector<unsigned int> servoMotorIndices; /**< The indices of the servo motors in the \c ServoMotorBank */
+  std::vector<unsigned int> servoMotorOffsets; /**< The indices of the values of the servo motors in the input buffer */
+  std::vector<SimRobotCore3::ActuatorPort*> ports; /**< Actuators that are set through \c setValue */
+  std::vector<unsigned int> portOffsets; /**< The indices of the values of the actuators in \c ports in the input buffer */
+  unsigned int size; /**< The number of actuators */
+
+  //API
+  unsigned int getSize() const override {return size;}
+  void setValues(const float* values) override;
+};
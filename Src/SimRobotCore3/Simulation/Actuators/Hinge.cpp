@@ -11,7 +11,6 @@
 #include "Simulation/Axis.h"
 #include "Simulation/Body.h"
 #include "Simulation/Motors/ServoMotor.h"
-#include "Simulation/Motors/VelocityMotor.h"
 #include "Simulation/Simulation.h"
 #include "Platform/Assert.h"
 #include "Tools/Math/Rotation.h"
@@ -58,11 +57,7 @@ void Hinge::createPhysics(GraphicsContext& graphicsContext)
 
   // create motor
   if(axis->motor)
-  {
     axis->motor->create(this);
-    if(!dynamic_cast<VelocityMotor*>(axis->motor) && axis->deflection) // Move setpoint to a position inside the deflection range
-      axis->motor->setpoint = axis->deflection->offset;
-  }
 }
 
 const QIcon* Hinge::getIcon() const
@@ -37,7 +37,7 @@ void Appearance::createGraphics(GraphicsContext& graphicsContext)
 
   ASSERT(!mesh);
   mesh = createMesh(graphicsContext);
-  ASSERT(!mesh == !surface);
+  ASSERT(!mesh == !surface || (!mesh && isMeshOptional()));
 
   graphicsContext.pushModelMatrix(poseInParent);
   ASSERT(!modelMatrix);
@@ -73,6 +73,12 @@ protected:
     return nullptr;
   }
 
+  /**
+   * Returns whether \c createMesh may fail for this appearance although it has a surface
+   * @return Whether the mesh is optional
+   */
+  virtual bool isMeshOptional() const {return false;}
+
   Surface* surface = nullptr; /**< The visual material of the object */
 
 private:
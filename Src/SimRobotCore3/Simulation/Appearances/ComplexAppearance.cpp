@@ -6,11 +6,12 @@
 
 #include "ComplexAppearance.h"
 #include "Platform/Assert.h"
+#include "Simulation/Geometries/MeshGeometry.h"
 #include "Simulation/Simulation.h"
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <functional>
-#include <unordered_map>
 
 void ComplexAppearance::PrimitiveGroup::addParent(Element& element)
 {
@@ -20,6 +21,12 @@ void ComplexAppearance::PrimitiveGroup::addParent(Element& element)
 
 void ComplexAppearance::Vertices::addParent(Element& element)
 {
+  if(MeshGeometry* meshGeometry = dynamic_cast<MeshGeometry*>(&element); meshGeometry)
+  {
+    ASSERT(!meshGeometry->vertices);
+    meshGeometry->vertices = this;
+    return;
+  }
   ComplexAppearance* complexAppearance = dynamic_cast<ComplexAppearance*>(&element);
   ASSERT(!complexAppearance->vertices);
   complexAppearance->vertices = this;
@@ -87,17 +94,38 @@ GraphicsContext::Mesh* ComplexAppearance::createMeshImpl(GraphicsContext& graphi
   GraphicsContext::VertexBuffer<VertexType>* vertexBuffer = graphicsContext.requestVertexBuffer<VertexType>();
   vertexBuffer->vertices.reserve(verticesSize);
 
-  std::unordered_map<std::uint64_t, unsigned int> indexMap;
+  // Maps (vertex index, normal index) pairs to the index in the vertex buffer plus 1 (0 means not added yet).
+  // Without normals, the vertex index alone is the key and the table is indexed directly. Otherwise, it is
+  // an open addressing hash table with linear probing that is at most half full.
+  std::size_t numOfReferences = 0;
+  for(const PrimitiveGroup* primitiveGroup : primitiveGroups)
+    numOfReferences += primitiveGroup->vertices.size();
+  std::size_t tableSize = verticesSize;
+  unsigned int shift = 64;
+  if(normals)
+  {
+    numOfReferences /= 2;
+    for(tableSize = 16, shift = 60; tableSize < 2 * numOfReferences; tableSize <<= 1, --shift);
+  }
+  std::vector<std::uint64_t> keys(normals ? tableSize : 0);
+  std::vector<unsigned int> indexMap(tableSize);
 
-  auto getVertex = [this, vertexBuffer, &indexMap](std::list<unsigned int>::const_iterator& iter) -> unsigned int
+  auto getVertex = [this, vertexBuffer, &keys, &indexMap, shift](std::vector<unsigned int>::const_iterator& iter) -> unsigned int
   {
     const unsigned int vertexIndex = *(iter++);
     const unsigned int normalIndex = normals ? *(iter++) : vertexIndex;
     if(vertexIndex >= vertices->vertices.size() || (normals && normalIndex >= normals->normals.size()))
       return 0; // Same as above: This does not make sense, but is better than crashing.
-    const std::uint64_t combinedIndex = normals ? (vertexIndex | (static_cast<std::uint64_t>(normalIndex) << 32)) : static_cast<std::uint64_t>(vertexIndex);
+    std::size_t slot = vertexIndex;
+    if(normals)
+    {
+      const std::uint64_t combinedIndex = vertexIndex | (static_cast<std::uint64_t>(normalIndex) << 32);
+      const std::size_t mask = keys.size() - 1;
+      for(slot = static_cast<std::size_t>((combinedIndex * 0x9e3779b97f4a7c15ull) >> shift); indexMap[slot] && keys[slot] != combinedIndex; slot = (slot + 1) & mask);
+      keys[slot] = combinedIndex;
+    }
     // Has this vertex already been added to the buffer?
-    unsigned int& index = indexMap[combinedIndex];
+    unsigned int& index = indexMap[slot];
     if(index)
       return index - 1;
     // Append a new vertex.
@@ -86,7 +86,7 @@ public:
   {
   public:
     Mode mode; /**< The primitive group type (\c triangles, \c quads, ...) */
-    std::list<unsigned int> vertices; /**< The indices of the vertices used to draw the primitive */
+    std::vector<unsigned int> vertices; /**< The indices of the vertices used to draw the primitive */
 
     /**
      * Constructor
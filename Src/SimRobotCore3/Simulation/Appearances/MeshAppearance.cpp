@@ -0,0 +1,735 @@
+/**
+ * @file Simulation/Appearances/MeshAppearance.cpp
+ * Implementation of class MeshAppearance
+ */
+
+#include "MeshAppearance.h"
+#include "Platform/Assert.h"
+#include "Simulation/Simulation.h"
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+  /**
+   * The geometry read from a mesh file, which is moved into the buffers of the graphics context.
+   * @tparam VertexType The vertex type from the \c GraphicsContext
+   */
+  template<typename VertexType>
+  struct MeshData
+  {
+    std::vector<VertexType> vertices; /**< The vertices */
+    std::vector<std::uint32_t> indices; /**< The indices of the triangles (empty if every three consecutive vertices form a triangle) */
+    bool hasNormals = false; /**< Whether the normals of the vertices have been read from the file */
+  };
+
+  /**
+   * Appends a vertex to an array.
+   * @tparam VertexType The vertex type from the \c GraphicsContext
+   * @param vertices The array
+   * @param position The position of the vertex
+   * @param normal The normal of the vertex
+   * @param textureCoordinates The texture coordinates of the vertex (ignored if the vertex type does not have any)
+   */
+  template<typename VertexType>
+  void addVertex(std::vector<VertexType>& vertices, const Vector3f& position, const Vector3f& normal, const Vector2f& textureCoordinates)
+  {
+    if constexpr(std::is_same_v<VertexType, GraphicsContext::VertexPNT>)
+      vertices.emplace_back(position, normal, textureCoordinates);
+    else
+      vertices.emplace_back(position, normal);
+  }
+
+  /**
+   * Sets the normal of each vertex to the average of the normals of the triangles it is part of.
+   * @tparam VertexType The vertex type from the \c GraphicsContext
+   * @param mesh The mesh with indexed triangles
+   */
+  template<typename VertexType>
+  void calcNormals(MeshData<VertexType>& mesh)
+  {
+    for(VertexType& vertex : mesh.vertices)
+      vertex.normal = Vector3f::Zero();
+    for(std::size_t i = 0; i < mesh.indices.size(); i += 3)
+    {
+      VertexType& v1 = mesh.vertices[mesh.indices[i]];
+      VertexType& v2 = mesh.vertices[mesh.indices[i + 1]];
+      VertexType& v3 = mesh.vertices[mesh.indices[i + 2]];
+      const Vector3f n = (v2.position - v1.position).cross(v3.position - v1.position).normalized();
+      v1.normal += n;
+      v2.normal += n;
+      v3.normal += n;
+    }
+    for(VertexType& vertex : mesh.vertices)
+      vertex.normal.normalize();
+  }
+
+  /**
+   * Skips spaces and tabs (but not line breaks).
+   * @param p The current position in a zero-terminated text
+   */
+  void skipBlanks(const char*& p)
+  {
+    while(*p == ' ' || *p == '\t')
+      ++p;
+  }
+
+  /**
+   * Skips the rest of the current line including the line break.
+   * @param p The current position in a zero-terminated text
+   */
+  void skipLine(const char*& p)
+  {
+    while(*p && *p != '\n')
+      ++p;
+    if(*p)
+      ++p;
+  }
+
+  /**
+   * Reads a float from the current line of a text.
+   * @param p The current position in a zero-terminated text
+   * @param value The value read
+   * @return Whether there was a float before the end of the line
+   */
+  bool readFloat(const char*& p, float& value)
+  {
+    skipBlanks(p);
+    char* next;
+    value = std::strtof(p, &next);
+    if(next == p || *p == '\n' || *p == '\r')
+      return false;
+    p = next;
+    return true;
+  }
+
+  /**
+   * Loads an STL file. The triangles are not indexed, because their vertices get the normal of the triangle.
+   * @tparam VertexType The vertex type from the \c GraphicsContext
+   * @param contents The contents of the file (zero-terminated)
+   * @param unit The factor that converts the coordinates to m
+   * @param mesh The mesh to fill
+   * @return Whether the file could be parsed
+   */
+  template<typename VertexType>
+  bool loadSTL(const QByteArray& contents, float unit, MeshData<VertexType>& mesh)
+  {
+    auto addTriangle = [&mesh](const Vector3f& p1, const Vector3f& p2, const Vector3f& p3)
+    {
+      // The normals in STL files are often missing or inaccurate, so calculate them.
+      const Vector3f n = (p2 - p1).cross(p3 - p1).normalized();
+      addVertex(mesh.vertices, p1, n, Vector2f::Zero());
+      addVertex(mesh.vertices, p2, n, Vector2f::Zero());
+      addVertex(mesh.vertices, p3, n, Vector2f::Zero());
+    };
+
+    // Binary files start with an 80 byte header (which may also start with "solid") and the number of triangles.
+    const std::size_t size = static_cast<std::size_t>(contents.size());
+    std::uint32_t numOfTriangles = 0;
+    if(size >= 84)
+    {
+      const unsigned char* count = reinterpret_cast<const unsigned char*>(contents.constData() + 80);
+      numOfTriangles = count[0] | count[1] << 8 | count[2] << 16 | static_cast<std::uint32_t>(count[3]) << 24;
+    }
+    if(size >= 84 && size == 84 + std::size_t(50) * numOfTriangles)
+    {
+      mesh.vertices.reserve(std::size_t(3) * numOfTriangles);
+      for(const char* p = contents.constData() + 84, * end = contents.constData() + size; p < end; p += 50)
+      {
+        unsigned char bytes[36];
+        std::memcpy(bytes, p + 12, sizeof(bytes)); // skip the normal
+        if constexpr(std::endian::native == std::endian::big)
+          for(unsigned char* value = bytes; value < bytes + sizeof(bytes); value += 4)
+            std::reverse(value, value + 4);
+        float values[9];
+        std::memcpy(values, bytes, sizeof(values));
+        addTriangle(Vector3f(values[0], values[1], values[2]) * unit,
+                    Vector3f(values[3], values[4], values[5]) * unit,
+                    Vector3f(values[6], values[7], values[8]) * unit);
+      }
+    }
+    else
+    {
+      // The only thing that matters in ASCII files are the lines "vertex x y z".
+      Vector3f points[3];
+      std::size_t numOfPoints = 0;
+      for(const char* p = contents.constData(); (p = std::strstr(p, "vertex"));)
+      {
+        p += 6;
+        Vector3f& point = points[numOfPoints++];
+        if(!readFloat(p, point.x()) || !readFloat(p, point.y()) || !readFloat(p, point.z()))
+          return false;
+        point *= unit;
+        if(numOfPoints == 3)
+        {
+          addTriangle(points[0], points[1], points[2]);
+          numOfPoints = 0;
+        }
+      }
+    }
+    mesh.hasNormals = true;
+    return true;
+  }
+
+  /** The description of a PLY file from its header */
+  struct PLYHeader
+  {
+    /** The scalar types of properties */
+    enum Type
+    {
+      int8,
+      uint8,
+      int16,
+      uint16,
+      int32,
+      uint32,
+      float32,
+      float64
+    };
+
+    /** A property of an element */
+    struct Property
+    {
+      std::string name; /**< The name of the property */
+      Type type = float32; /**< The type of the property (or of the list entries) */
+      Type countType = uint8; /**< The type of the number of entries (if the property is a list) */
+      bool isList = false; /**< Whether the property is a list */
+    };
+
+    /** An element, i.e. an array of records */
+    struct Element
+    {
+      std::string name; /**< The name of the element */
+      std::size_t count = 0; /**< The number of records */
+      std::vector<Property> properties; /**< The properties of each record */
+    };
+
+    enum
+    {
+      ascii,
+      littleEndian,
+      bigEndian
+    } encoding = ascii; /**< The encoding of the data */
+    std::vector<Element> elements; /**< The elements in the order of the data */
+    std::size_t size = 0; /**< The size of the header in bytes */
+
+    /**
+     * Parses the header of a PLY file.
+     * @param contents The contents of the file
+     * @return Whether the header is valid
+     */
+    bool read(const QByteArray& contents)
+    {
+      const qsizetype endOfHeader = contents.indexOf("end_header");
+      if(!contents.startsWith("ply") || endOfHeader < 0)
+        return false;
+      size = static_cast<std::size_t>(contents.indexOf('\n', endOfHeader) + 1);
+      if(!size)
+        return false;
+      std::istringstream stream(std::string(contents.constData(), static_cast<std::size_t>(endOfHeader)));
+      std::string line;
+      std::getline(stream, line);
+      while(std::getline(stream, line))
+      {
+        std::istringstream lineStream(line);
+        std::string keyword;
+        lineStream >> keyword;
+        if(keyword == "format")
+        {
+          std::string format;
+          lineStream >> format;
+          if(format == "ascii")
+            encoding = ascii;
+          else if(format == "binary_little_endian")
+            encoding = littleEndian;
+          else if(format == "binary_big_endian")
+            encoding = bigEndian;
+          else
+            return false;
+        }
+        else if(keyword == "element")
+        {
+          Element& element = elements.emplace_back();
+          if(!(lineStream >> element.name >> element.count))
+            return false;
+        }
+        else if(keyword == "property")
+        {
+          if(elements.empty())
+            return false;
+          Property& property = elements.back().properties.emplace_back();
+          std::string type;
+          lineStream >> type;
+          if(type == "list")
+          {
+            std::string countType;
+            lineStream >> countType >> type;
+            property.isList = true;
+            if(!parseType(countType, property.countType))
+              return false;
+          }
+          if(!parseType(type, property.type) || !(lineStream >> property.name))
+            return false;
+        }
+      }
+      return true;
+    }
+
+    /**
+     * Returns the size of a scalar type in binary files.
+     * @param type The type
+     * @return The size in bytes
+     */
+    static std::size_t getSize(Type type)
+    {
+      static const std::size_t sizes[] = {1, 1, 2, 2, 4, 4, 4, 8};
+      return sizes[type];
+    }
+
+  private:
+    /**
+     * Converts the name of a type.
+     * @param name The name of the type
+     * @param type The type
+     * @return Whether the name is valid
+     */
+    static bool parseType(const std::string& name, Type& type)
+    {
+      static const std::unordered_map<std::string, Type> types =
+      {
+        {"char", int8}, {"int8", int8}, {"uchar", uint8}, {"uint8", uint8},
+        {"short", int16}, {"int16", int16}, {"ushort", uint16}, {"uint16", uint16},
+        {"int", int32}, {"int32", int32}, {"uint", uint32}, {"uint32", uint32},
+        {"float", float32}, {"float32", float32}, {"double", float64}, {"float64", float64}
+      };
+      const auto t = types.find(name);
+      if(t == types.end())
+        return false;
+      type = t->second;
+      return true;
+    }
+  };
+
+  /** Reads the scalar values from the data of a PLY file */
+  class PLYReader
+  {
+  public:
+    /**
+     * Constructor.
+     * @param header The header of the file
+     * @param contents The contents of the file (zero-terminated)
+     */
+    PLYReader(const PLYHeader& header, const QByteArray& contents) :
+      current(contents.constData() + header.size),
+      end(contents.constData() + contents.size()),
+      encoding(header.encoding)
+    {}
+
+    /**
+     * Checks whether the data left can hold the records of an element. This rejects counts in malformed headers
+     * that are too large to reserve memory for.
+     * @param element The element that is read next
+     * @return Whether the number of records is plausible
+     */
+    bool canContain(const PLYHeader::Element& element) const
+    {
+      // A binary record needs at least its scalars and list counts, an ASCII record at least one character and a
+      // separator per property (except for the last value of the file).
+      std::size_t minSize = 0;
+      for(const PLYHeader::Property& property : element.properties)
+        minSize += encoding == PLYHeader::ascii ? 2 : PLYHeader::getSize(property.isList ? property.countType : property.type);
+      const std::size_t available = static_cast<std::size_t>(end - current) + (encoding == PLYHeader::ascii ? 1 : 0);
+      return element.count <= available / std::max<std::size_t>(minSize, 1);
+    }
+
+    /**
+     * Reads a value.
+     * @param type The type of the value
+     * @param value The value read
+     * @return Whether there was a value left
+     */
+    bool read(PLYHeader::Type type, double& value)
+    {
+      if(encoding == PLYHeader::ascii)
+      {
+        char* next;
+        value = std::strtod(current, &next);
+        if(next == current)
+          return false;
+        current = next;
+        return true;
+      }
+
+      const std::size_t size = PLYHeader::getSize(type);
+      if(static_cast<std::size_t>(end - current) < size)
+        return false;
+      unsigned char bytes[8];
+      std::memcpy(bytes, current, size);
+      current += size;
+      if((encoding == PLYHeader::bigEndian) != (std::endian::native == std::endian::big))
+        std::reverse(bytes, bytes + size);
+      switch(type)
+      {
+        case PLYHeader::int8:
+          value = static_cast<std::int8_t>(bytes[0]);
+          break;
+        case PLYHeader::uint8:
+          value = bytes[0];
+          break;
+        case PLYHeader::int16:
+          value = convert<std::int16_t>(bytes);
+          break;
+        case PLYHeader::uint16:
+          value = convert<std::uint16_t>(bytes);
+          break;
+        case PLYHeader::int32:
+          value = convert<std::int32_t>(bytes);
+          break;
+        case PLYHeader::uint32:
+          value = convert<std::uint32_t>(bytes);
+          break;
+        case PLYHeader::float32:
+          value = convert<float>(bytes);
+          break;
+        case PLYHeader::float64:
+          value = convert<double>(bytes);
+          break;
+      }
+      return true;
+    }
+
+  private:
+    const char* current; /**< The current position in the data */
+    const char* end; /**< The end of the data */
+    decltype(PLYHeader::encoding) encoding; /**< The encoding of the data */
+
+    /**
+     * Reinterprets bytes in native byte order as a value.
+     * @tparam T The type of the value
+     * @param bytes The bytes
+     * @return The value
+     */
+    template<typename T>
+    static T convert(const unsigned char* bytes)
+    {
+      T value;
+      std::memcpy(&value, bytes, sizeof(T));
+      return value;
+    }
+  };
+
+  /**
+   * Loads a PLY file. Only the elements "vertex" and "face" are used, polygons are triangulated as fans.
+   * @tparam VertexType The vertex type from the \c GraphicsContext
+   * @param header The header of the file
+   * @param contents The contents of the file (zero-terminated)
+   * @param unit The factor that converts the coordinates to m
+   * @param mesh The mesh to fill
+   * @return Whether the file could be parsed
+   */
+  template<typename VertexType>
+  bool loadPLY(const PLYHeader& header, const QByteArray& contents, float unit, MeshData<VertexType>& mesh)
+  {
+    enum Role
+    {
+      none, x, y, z, nx, ny, nz, s, t
+    };
+    static const std::unordered_map<std::string, Role> roles =
+    {
+      {"x", x}, {"y", y}, {"z", z}, {"nx", nx}, {"ny", ny}, {"nz", nz},
+      {"s", s}, {"u", s}, {"texture_u", s}, {"texture_s", s},
+      {"t", t}, {"v", t}, {"texture_v", t}, {"texture_t", t}
+    };
+
+    PLYReader reader(header, contents);
+    double value;
+    std::vector<std::uint32_t> polygon;
+    for(const PLYHeader::Element& element : header.elements)
+    {
+      const bool isVertex = element.name == "vertex";
+      const bool isFace = element.name == "face";
+      std::vector<Role> propertyRoles;
+      for(const PLYHeader::Property& property : element.properties)
+      {
+        const auto role = roles.find(property.name);
+        propertyRoles.push_back(isVertex && !property.isList && role != roles.end() ? role->second : none);
+        if(isVertex && (property.name == "nx" || property.name == "ny" || property.name == "nz"))
+          mesh.hasNormals = true;
+      }
+      if(!reader.canContain(element))
+        return false;
+      if(isVertex)
+        mesh.vertices.reserve(element.count);
+      else if(isFace)
+        mesh.indices.reserve(element.count * 3);
+
+      for(std::size_t i = 0; i < element.count; ++i)
+      {
+        float values[t + 1] = {0.f};
+        for(std::size_t j = 0; j < element.properties.size(); ++j)
+        {
+          const PLYHeader::Property& property = element.properties[j];
+          if(!property.isList)
+          {
+            if(!reader.read(property.type, value))
+              return false;
+            values[propertyRoles[j]] = static_cast<float>(value);
+            continue;
+          }
+          if(!reader.read(property.countType, value))
+            return false;
+          const std::size_t count = static_cast<std::size_t>(value);
+          const bool isPolygon = isFace && (property.name == "vertex_indices" || property.name == "vertex_index");
+          polygon.clear();
+          for(std::size_t k = 0; k < count; ++k)
+          {
+            if(!reader.read(property.type, value))
+              return false;
+            if(isPolygon)
+              polygon.push_back(static_cast<std::uint32_t>(value));
+          }
+          for(std::size_t k = 2; k < polygon.size(); ++k)
+          {
+            mesh.indices.push_back(polygon[0]);
+            mesh.indices.push_back(polygon[k - 1]);
+            mesh.indices.push_back(polygon[k]);
+          }
+        }
+        if(isVertex)
+          addVertex(mesh.vertices, Vector3f(values[x], values[y], values[z]) * unit, Vector3f(values[nx], values[ny], values[nz]), Vector2f(values[s], values[t]));
+      }
+    }
+
+    // The vertex element might follow the face element, so the indices can only be checked now.
+    for(const std::uint32_t index : mesh.indices)
+      if(index >= mesh.vertices.size())
+        return false;
+    return true;
+  }
+
+  /**
+   * Loads a Wavefront OBJ file. Only vertices, normals, texture coordinates and faces are used, polygons are triangulated as fans.
+   * @tparam VertexType The vertex type from the \c GraphicsContext
+   * @param contents The contents of the file (zero-terminated)
+   * @param unit The factor that converts the coordinates to m
+   * @param mesh The mesh to fill
+   * @return Whether the file could be parsed
+   */
+  template<typename VertexType>
+  bool loadOBJ(const QByteArray& contents, float unit, MeshData<VertexType>& mesh)
+  {
+    constexpr bool withTextureCoordinates = std::is_same_v<VertexType, GraphicsContext::VertexPNT>;
+    std::vector<Vector3f> positions;
+    std::vector<Vector3f> normals;
+    std::vector<Vector2f> texCoords;
+    std::vector<std::uint32_t> polygon;
+
+    // Maps (position, texture coordinates, normal) triples to the index of the vertex created for them.
+    struct Key
+    {
+      std::uint32_t position;
+      std::uint32_t texCoord;
+      std::uint32_t normal;
+
+      bool operator==(const Key& other) const = default;
+    };
+    struct Hasher
+    {
+      std::size_t operator()(const Key& key) const
+      {
+        return static_cast<std::size_t>((key.position * 0x9e3779b97f4a7c15ull) ^ (key.texCoord * 0xc2b2ae3d27d4eb4full) ^ (key.normal * 0x165667b19e3779f9ull));
+      }
+    };
+    std::unordered_map<Key, std::uint32_t, Hasher> vertexMap;
+
+    // Converts a 1-based or negative (i.e. relative to the end) index into a 0-based one (-1 if it is invalid).
+    auto resolve = [](long index, std::size_t size) -> long
+    {
+      const long resolved = index < 0 ? static_cast<long>(size) + index : index - 1;
+      return resolved >= 0 && resolved < static_cast<long>(size) ? resolved : -1;
+    };
+
+    mesh.hasNormals = true;
+    for(const char* p = contents.constData(); *p; skipLine(p))
+    {
+      skipBlanks(p);
+      if(p[0] == 'v' && (p[1] == ' ' || p[1] == '\t'))
+      {
+        ++p;
+        Vector3f& position = positions.emplace_back();
+        if(!readFloat(p, position.x()) || !readFloat(p, position.y()) || !readFloat(p, position.z()))
+          return false;
+        position *= unit;
+      }
+      else if(p[0] == 'v' && p[1] == 'n' && (p[2] == ' ' || p[2] == '\t'))
+      {
+        p += 2;
+        Vector3f& normal = normals.emplace_back();
+        if(!readFloat(p, normal.x()) || !readFloat(p, normal.y()) || !readFloat(p, normal.z()))
+          return false;
+      }
+      else if(p[0] == 'v' && p[1] == 't' && (p[2] == ' ' || p[2] == '\t'))
+      {
+        p += 2;
+        Vector2f& texCoord = texCoords.emplace_back();
+        if(!readFloat(p, texCoord.x()))
+          return false;
+        if(!readFloat(p, texCoord.y()))
+          texCoord.y() = 0.f;
+      }
+      else if(p[0] == 'f' && (p[1] == ' ' || p[1] == '\t'))
+      {
+        ++p;
+        polygon.clear();
+        for(skipBlanks(p); *p && *p != '\n' && *p != '\r' && *p != '#'; skipBlanks(p))
+        {
+          // Parse "v", "v/vt", "v//vn" or "v/vt/vn".
+          char* next;
+          const long position = resolve(std::strtol(p, &next, 10), positions.size());
+          if(next == p || position < 0)
+            return false;
+          p = next;
+          long texCoord = -1;
+          long normal = -1;
+          if(*p == '/')
+          {
+            if(*++p != '/')
+            {
+              texCoord = resolve(std::strtol(p, &next, 10), texCoords.size());
+              if(next == p || texCoord < 0)
+                return false;
+              p = next;
+            }
+            if(*p == '/')
+            {
+              ++p;
+              normal = resolve(std::strtol(p, &next, 10), normals.size());
+              if(next == p || normal < 0)
+                return false;
+              p = next;
+            }
+          }
+          if(normal < 0)
+            mesh.hasNormals = false;
+          if(!withTextureCoordinates)
+            texCoord = -1;
+
+          const Key key = {static_cast<std::uint32_t>(position), static_cast<std::uint32_t>(texCoord), static_cast<std::uint32_t>(normal)};
+          const auto [entry, inserted] = vertexMap.emplace(key, static_cast<std::uint32_t>(mesh.vertices.size()));
+          if(inserted)
+            addVertex(mesh.vertices, positions[position],
+                      normal < 0 ? Vector3f::Zero() : normals[normal],
+                      texCoord < 0 ? Vector2f::Zero() : texCoords[texCoord]);
+          polygon.push_back(entry->second);
+        }
+        for(std::size_t k = 2; k < polygon.size(); ++k)
+        {
+          mesh.indices.push_back(polygon[0]);
+          mesh.indices.push_back(polygon[k - 1]);
+          mesh.indices.push_back(polygon[k]);
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Loads a mesh file and moves the result into the buffers of a graphics context.
+   * @tparam VertexType The vertex type from the \c GraphicsContext
+   * @param graphicsContext The graphics context to create the mesh in
+   * @param format The format of the file
+   * @param contents The contents of the file (zero-terminated)
+   * @param plyHeader The header if the file is a PLY file
+   * @param unit The factor that converts the coordinates to m
+   * @return The resulting mesh (or \c nullptr if the file could not be parsed)
+   */
+  template<typename VertexType>
+  GraphicsContext::Mesh* loadMesh(GraphicsContext& graphicsContext, MeshAppearance::Format format, const QByteArray& contents, const PLYHeader& plyHeader, float unit)
+  {
+    MeshData<VertexType> mesh;
+    bool success = false;
+    switch(format)
+    {
+      case MeshAppearance::stl:
+        success = loadSTL(contents, unit, mesh);
+        break;
+      case MeshAppearance::ply:
+        success = loadPLY(plyHeader, contents, unit, mesh);
+        break;
+      case MeshAppearance::obj:
+        success = loadOBJ(contents, unit, mesh);
+        break;
+      default:
+        break;
+    }
+    if(!success || mesh.vertices.empty() || (format != MeshAppearance::stl && mesh.indices.empty()))
+      return nullptr;
+    if(!mesh.hasNormals)
+      calcNormals(mesh);
+
+    GraphicsContext::VertexBuffer<VertexType>* vertexBuffer = graphicsContext.requestVertexBuffer<VertexType>();
+    vertexBuffer->vertices = std::move(mesh.vertices);
+    vertexBuffer->finish();
+    GraphicsContext::IndexBuffer* indexBuffer = nullptr;
+    if(!mesh.indices.empty())
+    {
+      indexBuffer = graphicsContext.requestIndexBuffer();
+      indexBuffer->indices = std::move(mesh.indices);
+    }
+    return graphicsContext.requestMesh(vertexBuffer, indexBuffer, GraphicsContext::triangleList);
+  }
+}
+
+MeshAppearance::Format MeshAppearance::getFormat(const std::string& file)
+{
+  const QString suffix = QFileInfo(QString::fromStdString(file)).suffix().toLower();
+  return suffix == "stl" ? stl : suffix == "ply" ? ply : suffix == "obj" ? obj : unknown;
+}
+
+GraphicsContext::Mesh* MeshAppearance::createMesh(GraphicsContext& graphicsContext)
+{
+  ASSERT(surface);
+
+  // The mesh only depends on the file, the unit and whether texture coordinates are needed.
+  const std::string key = file + '\n' + std::to_string(unit) + (surface->texture ? "\nt" : "");
+  if(const auto cachedMesh = Simulation::simulation->meshAppearanceMeshCache.find(key); cachedMesh != Simulation::simulation->meshAppearanceMeshCache.end())
+    return cachedMesh->second;
+
+  GraphicsContext::Mesh* mesh = nullptr;
+  QFile qFile(QString::fromStdString(file));
+  if(const Format format = getFormat(file); format != unknown && qFile.open(QIODevice::ReadOnly))
+  {
+    // The text parsers rely on the terminating zero that QByteArray guarantees.
+    const QByteArray contents = qFile.readAll();
+    PLYHeader plyHeader;
+    if(format != ply || plyHeader.read(contents))
+    {
+      // Texture coordinates are only used if there are any (which is cheap to check).
+      bool withTextureCoordinates = false;
+      if(surface->texture && format == ply)
+        for(const PLYHeader::Element& element : plyHeader.elements)
+          if(element.name == "vertex")
+            for(const PLYHeader::Property& property : element.properties)
+              withTextureCoordinates |= property.name == "s" || property.name == "u" || property.name == "texture_u" || property.name == "texture_s";
+      if(surface->texture && format == obj)
+        withTextureCoordinates = contents.startsWith("vt ") || contents.contains("\nvt ");
+
+      mesh = withTextureCoordinates ?
+             loadMesh<GraphicsContext::VertexPNT>(graphicsContext, format, contents, plyHeader, unit) :
+             loadMesh<GraphicsContext::VertexPN>(graphicsContext, format, contents, plyHeader, unit);
+    }
+  }
+
+  Simulation::simulation->meshAppearanceMeshCache[key] = mesh;
+  return mesh;
+}
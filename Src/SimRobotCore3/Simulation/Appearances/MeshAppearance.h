@@ -0,0 +1,54 @@
+/**
+ * @file Simulation/Appearances/MeshAppearance.h
+ * Declaration of class MeshAppearance
+ */
+
+#pragma once
+
+#include "Graphics/GraphicsContext.h"
+#include "Simulation/Appearances/Appearance.h"
+#include <string>
+
+/**
+ * @class MeshAppearance
+ * The graphical representation of a shape that is loaded from a mesh file (STL, PLY or OBJ)
+ */
+class MeshAppearance : public Appearance
+{
+public:
+  /**
+   * @enum Format
+   * The supported mesh file formats
+   */
+  enum Format
+  {
+    unknown,
+    stl, /**< Binary or ASCII STL */
+    ply, /**< Binary (little or big endian) or ASCII PLY */
+    obj /**< Wavefront OBJ */
+  };
+
+  std::string file; /**< The mesh file */
+  float unit = 1.f; /**< The factor that converts the coordinates in the file to m */
+
+  /**
+   * Determines the format of a mesh file from its extension.
+   * @param file The name of the file
+   * @return The format (\c unknown if the extension is not supported)
+   */
+  static Format getFormat(const std::string& file);
+
+private:
+  /**
+   * Creates a mesh for this appearance in the given graphics context
+   * @param graphicsContext The graphics context to create the mesh in
+   * @return The resulting mesh (or \c nullptr if the file could not be loaded)
+   */
+  GraphicsContext::Mesh* createMesh(GraphicsContext& graphicsContext) override;
+
+  /**
+   * Returns whether \c createMesh may fail for this appearance although it has a surface
+   * @return Always \c true, because the file might not be loadable
+   */
+  bool isMeshOptional() const override {return true;}
+};
@@ -194,20 +194,36 @@ void Body::createGraphics(GraphicsContext& graphicsContext)
     child->createGraphics(graphicsContext);
 }
 
-void Body::updateTransformation()
+void Body::updateTransformation(float interpolation)
 {
-  // get pose from MuJoCo
-  mju_n2f(poseInWorld.translation.data(), Simulation::simulation->data->xpos + bodyIndex * 3, 3);
-  mju_n2f(poseInWorld.rotation.data(), Simulation::simulation->data->xmat + bodyIndex * 9, 9);
-  // from MuJoCo's row major format to column major
-  poseInWorld.rotation.transposeInPlace();
+  if(interpolation < 1.f)
+  {
+    // blend the poses of the previous and the current step
+    const mjtNum* previousPosition = Simulation::simulation->previousXpos.data() + bodyIndex * 3;
+    const mjtNum* position = Simulation::simulation->data->xpos + bodyIndex * 3;
+    for(int i = 0; i < 3; ++i)
+      poseInWorld.translation[i] = static_cast<float>(previousPosition[i] + (position[i] - previousPosition[i]) * interpolation);
+    const mjtNum* previousQuat = Simulation::simulation->previousXquat.data() + bodyIndex * 4;
+    const mjtNum* quat = Simulation::simulation->data->xquat + bodyIndex * 4;
+    const Quaternionf previousRotation(static_cast<float>(previousQuat[0]), static_cast<float>(previousQuat[1]), static_cast<float>(previousQuat[2]), static_cast<float>(previousQuat[3]));
+    const Quaternionf rotation(static_cast<float>(quat[0]), static_cast<float>(quat[1]), static_cast<float>(quat[2]), static_cast<float>(quat[3]));
+    poseInWorld.rotation = previousRotation.slerp(interpolation, rotation);
+  }
+  else
+  {
+    // get pose from MuJoCo
+    mju_n2f(poseInWorld.translation.data(), Simulation::simulation->data->xpos + bodyIndex * 3, 3);
+    mju_n2f(poseInWorld.rotation.data(), Simulation::simulation->data->xmat + bodyIndex * 9, 9);
+    // from MuJoCo's row major format to column major
+    poseInWorld.rotation.transposeInPlace();
+  }
 
   // Bodies are always relative to the world.
   poseInParent = poseInWorld;
 
   //
   for(Body* child : bodyChildren)
-    child->updateTransformation();
+    child->updateTransformation(interpolation);
 }
 
 void Body::drawAppearances(GraphicsContext& graphicsContext) const
@@ -260,7 +276,7 @@ void Body::move(const Vector3f& offset)
   // Unfortunately it seems that forward kinematics have to be done for the entire model again.
   mj_kinematics(Simulation::simulation->model, Simulation::simulation->data);
 
-  Simulation::simulation->scene->lastTransformationUpdateStep = Simulation::simulation->simulationStep - 1; // enforce transformation update
+  Simulation::simulation->scene->invalidateTransformations();
 }
 
 void Body::rotate(const RotationMatrix& rotation, const Vector3f& point)
@@ -288,7 +304,7 @@ void Body::rotate(const RotationMatrix& rotation, const Vector3f& point)
   // Unfortunately it seems that forward kinematics have to be done for the entire model again.
   mj_kinematics(Simulation::simulation->model, Simulation::simulation->data);
 
-  Simulation::simulation->scene->lastTransformationUpdateStep = Simulation::simulation->simulationStep - 1; // enforce transformation update
+  Simulation::simulation->scene->invalidateTransformations();
 }
 
 const float* Body::getPosition() const
@@ -361,7 +377,7 @@ void Body::move(const float* pos)
   // Unfortunately it seems that forward kinematics have to be done for the entire model again.
   mj_kinematics(Simulation::simulation->model, Simulation::simulation->data);
 
-  Simulation::simulation->scene->lastTransformationUpdateStep = Simulation::simulation->simulationStep - 1; // enforce transformation update
+  Simulation::simulation->scene->invalidateTransformations();
 }
 
 void Body::move(const float* pos, const float (*rot)[3])
@@ -386,7 +402,7 @@ void Body::move(const float* pos, const float (*rot)[3])
   // Unfortunately it seems that forward kinematics have to be done for the entire model again.
   mj_kinematics(Simulation::simulation->model, Simulation::simulation->data);
 
-  Simulation::simulation->scene->lastTransformationUpdateStep = Simulation::simulation->simulationStep - 1; // enforce transformation update
+  Simulation::simulation->scene->invalidateTransformations();
 }
 
 void Body::resetDynamics()
@@ -46,8 +46,11 @@ public:
    */
   void drawAppearances(GraphicsContext& graphicsContext) const override;
 
-  /** Updates the transformation from the parent to this body (since the pose of the body may have changed) */
-  void updateTransformation();
+  /**
+   * Updates the transformation from the parent to this body (since the pose of the body may have changed)
+   * @param interpolation Where to place the body between the previous (0) and the current step (1)
+   */
+  void updateTransformation(float interpolation = 1.f);
 
   /**
    * Moves the object and its children relative to its current position
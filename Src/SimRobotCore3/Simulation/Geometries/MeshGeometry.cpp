@@ -0,0 +1,87 @@
+/**
+ * @file Simulation/Geometries/MeshGeometry.cpp
+ * Implementation of class MeshGeometry
+ */
+
+#include "MeshGeometry.h"
+#include "Platform/Assert.h"
+#include "Simulation/Simulation.h"
+#include <mujoco/mujoco.h>
+#include <algorithm>
+
+mjsGeom* MeshGeometry::assembleGeometry(mjsBody* body)
+{
+  ASSERT(vertices);
+
+  // The mesh is only added once, even if the geometry is added to multiple bodies.
+  if(!meshName)
+  {
+    mjsMesh* mesh = mjs_addMesh(Simulation::simulation->spec, nullptr);
+    meshName = Simulation::simulation->getName(mjOBJ_MESH, "MeshGeometry", &meshIndex);
+    mjs_setName(mesh->element, meshName);
+    mjs_setFloat(mesh->uservert, reinterpret_cast<const float*>(vertices->vertices.data()), static_cast<int>(vertices->vertices.size() * 3));
+    mesh->maxhullvert = maxVertices > 0 ? maxVertices : -1;
+  }
+
+  mjsGeom* geom = mjs_addGeom(body, nullptr);
+  mjs_setName(geom->element, Simulation::simulation->getName(mjOBJ_GEOM, "MeshGeometry", nullptr, this));
+  geom->type = mjGEOM_MESH;
+  mjs_setString(geom->meshname, meshName);
+
+  innerRadius = 0.f;
+  innerRadiusSqr = 0.f;
+  outerRadius = 0.f;
+  for(const Vector3f& vertex : vertices->vertices)
+    outerRadius = std::max(outerRadius, vertex.norm());
+  return geom;
+}
+
+void MeshGeometry::createPhysics(GraphicsContext& graphicsContext)
+{
+  Geometry::createPhysics(graphicsContext);
+
+  Simulation::simulation->meshGeometries.push_back(this);
+}
+
+void MeshGeometry::createHullMesh(GraphicsContext& graphicsContext)
+{
+  const mjModel* model = Simulation::simulation->model;
+  ASSERT(!mesh);
+  ASSERT(meshIndex >= 0 && meshIndex < model->nmesh);
+  if(model->mesh_graphadr[meshIndex] < 0)
+    return;
+
+  // The graph consists of numvert, numface, vert_edgeadr[numvert], vert_globalid[numvert], edge_localid[numvert + 3 * numface] and face_globalid[3 * numface].
+  const int* graph = model->mesh_graph + model->mesh_graphadr[meshIndex];
+  const int numOfVertices = graph[0];
+  const int numOfFaces = graph[1];
+  const int* faces = graph + 2 + 3 * numOfVertices + 3 * numOfFaces;
+
+  // MuJoCo moves the mesh into its principal axes frame, so transform the vertices back into the frame of the geometry.
+  const float* meshVertices = model->mesh_vert + 3 * model->mesh_vertadr[meshIndex];
+  const Vector3f offset = Vector3f(static_cast<float>(model->mesh_pos[3 * meshIndex]), static_cast<float>(model->mesh_pos[3 * meshIndex + 1]), static_cast<float>(model->mesh_pos[3 * meshIndex + 2]));
+  auto getVertex = [&](int index)
+  {
+    mjtNum vertex[3], result[3];
+    mju_f2n(vertex, meshVertices + 3 * index, 3);
+    mju_rotVecQuat(result, vertex, model->mesh_quat + 4 * meshIndex);
+    return Vector3f(static_cast<float>(result[0]), static_cast<float>(result[1]), static_cast<float>(result[2])) + offset;
+  };
+
+  // Faces are drawn flat, so every face gets its own vertices.
+  GraphicsContext::VertexBuffer<GraphicsContext::VertexPN>* vertexBuffer = graphicsContext.requestVertexBuffer<GraphicsContext::VertexPN>();
+  vertexBuffer->vertices.reserve(3 * numOfFaces);
+  for(int i = 0; i < numOfFaces; ++i)
+  {
+    const Vector3f p1 = getVertex(faces[3 * i]);
+    const Vector3f p2 = getVertex(faces[3 * i + 1]);
+    const Vector3f p3 = getVertex(faces[3 * i + 2]);
+    const Vector3f normal = (p2 - p1).cross(p3 - p1).normalized();
+    vertexBuffer->vertices.emplace_back(p1, normal);
+    vertexBuffer->vertices.emplace_back(p2, normal);
+    vertexBuffer->vertices.emplace_back(p3, normal);
+  }
+  vertexBuffer->finish();
+
+  mesh = graphicsContext.requestMesh(vertexBuffer, nullptr, GraphicsContext::triangleList);
+}
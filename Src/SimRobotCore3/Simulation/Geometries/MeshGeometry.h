@@ -0,0 +1,46 @@
+/**
+ * @file Simulation/Geometries/MeshGeometry.h
+ * Declaration of class MeshGeometry
+ */
+
+#pragma once
+
+#include "Simulation/Appearances/ComplexAppearance.h"
+#include "Simulation/Geometries/Geometry.h"
+
+/**
+ * @class MeshGeometry
+ * A geometry that collides as the convex hull of a set of vertices
+ */
+class MeshGeometry : public Geometry
+{
+public:
+  ComplexAppearance::Vertices* vertices = nullptr; /**< The vertices whose convex hull forms the geometry */
+  int maxVertices = 0; /**< The maximum number of vertices of the convex hull (0 means unlimited) */
+
+  /**
+   * Creates the mesh that draws the convex hull. Must be called after the model has been compiled,
+   * because the hull is computed by MuJoCo.
+   * @param graphicsContext The graphics context to create resources in
+   */
+  void createHullMesh(GraphicsContext& graphicsContext);
+
+private:
+  const char* meshName = nullptr; /**< The name of the MuJoCo mesh (once it has been added to the model specification) */
+  int meshIndex = -1; /**< The index of the MuJoCo mesh */
+
+  /**
+   * Creates the geometry (not including \c translation and \c rotation)
+   * @param body The body to which to attach the geometry
+   * @param The created geometry
+   */
+  mjsGeom* assembleGeometry(mjsBody* body) override;
+
+  /**
+   * Creates the physical objects used by the OpenDynamicsEngine (ODE).
+   * These are a geometry object for collision detection and/or a body,
+   * if the simulation object is movable.
+   * @param graphicsContext The graphics context to create resources in
+   */
+  void createPhysics(GraphicsContext& graphicsContext) override;
+};
@@ -17,8 +17,6 @@ class Joint;
 class Motor : public Actuator::Port
 {
 public:
-  float setpoint = 0.f;
-
   /**
    * Creates the physical representation of the motor
    * @param joint The jointed that is controlled by this motor
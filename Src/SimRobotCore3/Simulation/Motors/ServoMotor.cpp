@@ -7,18 +7,17 @@
 #include "ServoMotor.h"
 #include "CoreModule.h"
 #include "Platform/Assert.h"
-#include "Simulation/Actuators/Joint.h"
+#include "Simulation/Actuators/Hinge.h"
 #include "Simulation/Axis.h"
 #include "Simulation/Scene.h"
 #include "Simulation/Simulation.h"
 #include "Tools/Math.h"
 #include <mujoco/mujoco.h>
+#include <algorithm>
 #include <cmath>
 
 ServoMotor::ServoMotor()
 {
-  Simulation::simulation->scene->actuators.push_back(this);
-
   positionSensor.sensorType = SimRobotCore3::SensorPort::floatSensor;
   positionSensor.dimensions.push_back(1);
   velocitySensor.sensorType = SimRobotCore3::SensorPort::floatSensor;
@@ -31,7 +30,6 @@ void ServoMotor::create(Joint* joint)
 {
   this->joint = joint;
   positionSensor.servoMotor = velocitySensor.servoMotor = torqueSensor.servoMotor = this;
-  lastPos = joint->axis->deflection ? joint->axis->deflection->offset : 0.f;
 
   mjsActuator* actuator = mjs_addActuator(Simulation::simulation->spec, nullptr);
 
@@ -45,39 +43,32 @@ void ServoMotor::create(Joint* joint)
 
   mjs_setString(actuator->target, joint->jointName);
 
-  actuator->ctrllimited = mjLIMITED_TRUE;
-  actuator->ctrlrange[0] = -maxForce;
-  actuator->ctrlrange[1] = maxForce;
-
   targetSize = 1u + static_cast<unsigned>(std::ceil(delay / Simulation::simulation->scene->stepLength));
   target = new NextTargets[targetSize];
+
+  ServoMotorBank& bank = Simulation::simulation->scene->servoMotors;
+  const float offset = joint->axis->deflection ? joint->axis->deflection->offset : 0.f;
+  // Hinges start with their setpoint at the offset, i.e. inside the deflection range, sliders at 0.
+  bankIndex = bank.add(*this, dynamic_cast<Hinge*>(joint) ? offset : 0.f, offset);
+  if(targetSize > 1)
+    bank.delayedMotors.push_back(this);
+
+  actuator->ctrllimited = mjLIMITED_TRUE;
+  actuator->ctrlrange[0] = -bank.maxForces[bankIndex];
+  actuator->ctrlrange[1] = bank.maxForces[bankIndex];
 }
 
 void ServoMotor::act()
 {
+  ServoMotorBank& bank = Simulation::simulation->scene->servoMotors;
   if(!isInitialized)
   {
-    ASSERT(Simulation::simulation->model->jnt_type[joint->jointIndex] == mjJNT_HINGE ||
-           Simulation::simulation->model->jnt_type[joint->jointIndex] == mjJNT_SLIDE);
     isInitialized = true;
-
-    Simulation::simulation->model->dof_damping[Simulation::simulation->model->jnt_dofadr[joint->jointIndex]] = 0.01f;
-    Simulation::simulation->model->dof_armature[Simulation::simulation->model->jnt_dofadr[joint->jointIndex]] = 0.01f;
-    Simulation::simulation->model->dof_frictionloss[Simulation::simulation->model->jnt_dofadr[joint->jointIndex]] = 0.0f;
     for(unsigned i = 0; i < targetSize; i++)
       target[i] = { static_cast<float>(Simulation::simulation->data->qpos[Simulation::simulation->model->jnt_qposadr[joint->jointIndex]]), static_cast<float>(Simulation::simulation->simulatedTime) };
   }
 
-  // For puppets just overwrite the values
-  if(isPuppet)
-  {
-    mju_f2n(&Simulation::simulation->data->qpos[Simulation::simulation->model->jnt_qposadr[joint->jointIndex]], &this->setpoint, 1);
-    const float zero = 0.f;
-    mju_f2n(&Simulation::simulation->data->qvel[Simulation::simulation->model->jnt_dofadr[joint->jointIndex]], &zero, 1);
-    return;
-  }
-
-  target[index] = { this->setpoint, static_cast<float>(Simulation::simulation->simulatedTime + delay) };
+  target[index] = { bank.targets[bankIndex], static_cast<float>(Simulation::simulation->simulatedTime + delay) };
 
   unsigned searchIndex = index;
   while(true)
@@ -96,51 +87,18 @@ void ServoMotor::act()
   if(index >= targetSize)
     index = 0;
 
-  float setpoint = lastExecutedSetpoint.setPoint;
-  float currentPos = static_cast<float>(Simulation::simulation->data->qpos[Simulation::simulation->model->jnt_qposadr[joint->jointIndex]]);
-  currentAngularVelocity = static_cast<float>(Simulation::simulation->data->qvel[Simulation::simulation->model->jnt_dofadr[joint->jointIndex]]) * velocityLowPassFactor
-                           + currentAngularVelocity * (1.f - velocityLowPassFactor);
-
-  if(Simulation::simulation->model->jnt_type[joint->jointIndex] == mjJNT_HINGE)
-  {
-    const float diff = normalize(currentPos - normalize(lastPos));
-    currentPos = lastPos + diff;
-  }
-
-  float newVel = controller.getOutput(currentPos, setpoint, currentAngularVelocity);
-  if(newVel > maxForce)
-    newVel = maxForce;
-  if(newVel < -maxForce)
-    newVel = -maxForce;
-  Simulation::simulation->data->ctrl[ctrlIndex] = newVel;
-
-  lastPos = currentPos;
-}
-
-float ServoMotor::Controller::getOutput(float currentPos, float setpoint, float vel)
-{
-  const float error = setpoint - currentPos;
-  const float result = p * error - d * vel;
-  lastError = error;
-  return result;
+  bank.setpoints[bankIndex] = lastExecutedSetpoint.setPoint;
 }
 
 void ServoMotor::setValue(float value)
 {
-  setpoint = value;
-  const Axis::Deflection* deflection = joint->axis->deflection;
-  if(deflection)
-  {
-    if(setpoint > deflection->max)
-      setpoint = deflection->max;
-    else if(setpoint < deflection->min)
-      setpoint = deflection->min;
-  }
+  ServoMotorBank& bank = Simulation::simulation->scene->servoMotors;
+  bank.targets[bankIndex] = std::clamp(value, bank.minTargets[bankIndex], bank.maxTargets[bankIndex]);
 }
 
 void ServoMotor::setPuppetState(bool isPuppet)
 {
-  this->isPuppet = isPuppet;
+  Simulation::simulation->scene->servoMotors.isPuppet[bankIndex] = isPuppet;
 }
 
 bool ServoMotor::getMinAndMax(float& min, float& max) const
@@ -157,9 +115,18 @@ bool ServoMotor::getMinAndMax(float& min, float& max) const
 
 void ServoMotor::setMotorParameters(float kP, float kD, float maxTorque)
 {
-  controller.p = kP;
-  controller.d = kD;
-  maxForce = maxTorque;
+  ServoMotorBank& bank = Simulation::simulation->scene->servoMotors;
+  bank.p[bankIndex] = kP;
+  bank.d[bankIndex] = kD;
+  bank.maxForces[bankIndex] = maxTorque;
+
+  // The compiled model must not clip the controller outputs to the previous limit.
+  if(ctrlIndex >= 0)
+  {
+    mjtNum* ctrlrange = Simulation::simulation->model->actuator_ctrlrange + 2 * ctrlIndex;
+    ctrlrange[0] = -maxTorque;
+    ctrlrange[1] = maxTorque;
+  }
 }
 
 void ServoMotor::PositionSensor::updateValue()
@@ -167,11 +134,19 @@ void ServoMotor::PositionSensor::updateValue()
   data.floatValue = static_cast<float>(Simulation::simulation->data->qpos[Simulation::simulation->model->jnt_qposadr[servoMotor->joint->jointIndex]]);
   if(Simulation::simulation->model->jnt_type[servoMotor->joint->jointIndex] == mjJNT_HINGE)
   {
-    const float diff = normalize(data.floatValue - normalize(servoMotor->lastPos));
-    data.floatValue = servoMotor->lastPos + diff;
+    const float lastPos = Simulation::simulation->scene->servoMotors.lastPositions[servoMotor->bankIndex];
+    const float diff = normalize(data.floatValue - normalize(lastPos));
+    data.floatValue = lastPos + diff;
   }
 }
 
+Sensor::Port::DataSource ServoMotor::PositionSensor::getDataSource(int& address) const
+{
+  // MuJoCo does not wrap hinge angles and lastPos follows the joint, so updateValue yields the raw value anyway.
+  address = Simulation::simulation->model->jnt_qposadr[servoMotor->joint->jointIndex];
+  return qpos;
+}
+
 bool ServoMotor::PositionSensor::getMinAndMax(float& min, float& max) const
 {
   const Axis::Deflection* deflection = servoMotor->joint->axis->deflection;
@@ -189,6 +164,12 @@ void ServoMotor::VelocitySensor::updateValue()
   data.floatValue = static_cast<float>(Simulation::simulation->data->qvel[Simulation::simulation->model->jnt_dofadr[servoMotor->joint->jointIndex]]);
 }
 
+Sensor::Port::DataSource ServoMotor::VelocitySensor::getDataSource(int& address) const
+{
+  address = Simulation::simulation->model->jnt_dofadr[servoMotor->joint->jointIndex];
+  return qvel;
+}
+
 bool ServoMotor::VelocitySensor::getMinAndMax(float& min, float& max) const
 {
   min = -servoMotor->maxVelocity;
@@ -203,8 +184,9 @@ void ServoMotor::TorqueSensor::updateValue()
 
 bool ServoMotor::TorqueSensor::getMinAndMax(float& min, float& max) const
 {
-  min = -servoMotor->maxForce;
-  max = servoMotor->maxForce;
+  const float maxForce = Simulation::simulation->scene->servoMotors.maxForces[servoMotor->bankIndex];
+  min = -maxForce;
+  max = maxForce;
   return true;
 }
 
@@ -18,7 +18,8 @@ class ServoMotor : public Motor
 public:
   /**
    * @class Controller
-   * A PID controller that controls the motor
+   * The gains of the PD controller that controls the motor as specified in the scene description
+   * (copied to the scene's \c ServoMotorBank in \c create, which is used from then on)
    */
   class Controller
   {
@@ -26,26 +27,14 @@ public:
     float p = 0.f;
     float i = 0.f;
     float d = 0.f;
-
-    /**
-     * Computes the controller output. Do not call this more than once per simulation step
-     * @param currentPos A measured value
-     * @param setpoint The desired value
-     * @return The controller output
-     */
-    float getOutput(float currentPos, float setpoint, float vel);
-
-  private:
-    float lastError = 0.f;
   };
 
-  Controller controller; /**< A PID controller that controls the motor */
+  Controller controller; /**< The initial gains of the PD controller that controls the motor */
   float maxVelocity = 0.f;
-  float maxForce = 0.f;
+  float maxForce = 0.f; /**< The initial maximum force (copied to the \c ServoMotorBank in \c create) */
   float delay = 1;
   bool isInitialized = false;
   float velocityLowPassFactor = 1.f;
-  float currentAngularVelocity = 0.f;
 
   /** Default constructor */
   ServoMotor();
@@ -62,6 +51,7 @@ private:
 
     //API
     void updateValue() override;
+    DataSource getDataSource(int& address) const override;
     bool getMinAndMax(float& min, float& max) const override;
   } positionSensor;
 
@@ -76,6 +66,7 @@ private:
 
     //API
     void updateValue() override;
+    DataSource getDataSource(int& address) const override;
     bool getMinAndMax(float& min, float& max) const override;
   } velocitySensor;
 
@@ -93,8 +84,7 @@ private:
     bool getMinAndMax(float& min, float& max) const override;
   } torqueSensor;
 
-  /** Last position of an angular hinge. */
-  float lastPos = 0;
+  unsigned int bankIndex = 0; /**< The index of this motor in the scene's \c ServoMotorBank */
 
   struct NextTargets
   {
@@ -107,15 +97,16 @@ private:
   unsigned index = 0;
   NextTargets lastExecutedSetpoint;
 
-  bool isPuppet = false;
-
   /**
    * Initializes the motor
    * @param joint The joint that is controlled by this motor
    */
   void create(Joint* joint) override;
 
-  /** Called before computing a simulation step to update the joint */
+  /**
+   * Called by the \c ServoMotorBank before computing a simulation step to determine the
+   * setpoint that is executed after the delay (only called for motors with a delay)
+   */
   void act() override;
 
   /** Registers this object at SimRobot's GUI */
@@ -126,4 +117,7 @@ private:
   void setPuppetState(bool isPuppet) override;
   void setMotorParameters(float kP, float kD, float maxTorque) override;
   bool getMinAndMax(float& min, float& max) const override;
+
+  friend class ActuatorGroup;
+  friend class ServoMotorBank;
 };
@@ -0,0 +1,112 @@
+/**
+ * @file Simulation/Motors/ServoMotorBank.cpp
+ * Implementation of class ServoMotorBank
+ */
+
+#include "ServoMotorBank.h"
+#include "Platform/Assert.h"
+#include "Simulation/Actuators/Joint.h"
+#include "Simulation/Axis.h"
+#include "Simulation/Motors/ServoMotor.h"
+#include "Simulation/Simulation.h"
+#include "Tools/Math.h"
+#include <mujoco/mujoco.h>
+#include <algorithm>
+#include <cfloat>
+
+unsigned int ServoMotorBank::add(ServoMotor& motor, float setpoint, float lastPosition)
+{
+  const Axis::Deflection* deflection = motor.joint->axis->deflection;
+  motors.push_back(&motor);
+  targets.push_back(setpoint);
+  setpoints.push_back(setpoint);
+  minTargets.push_back(deflection ? deflection->min : -FLT_MAX);
+  maxTargets.push_back(deflection ? deflection->max : FLT_MAX);
+  p.push_back(motor.controller.p);
+  d.push_back(motor.controller.d);
+  maxForces.push_back(motor.maxForce);
+  velocityLowPassFactors.push_back(motor.velocityLowPassFactor);
+  velocities.push_back(0.f);
+  lastPositions.push_back(lastPosition);
+  isPuppet.push_back(false);
+  return static_cast<unsigned int>(motors.size() - 1);
+}
+
+void ServoMotorBank::initialize()
+{
+  const mjModel* model = Simulation::simulation->model;
+  const std::size_t count = motors.size();
+  qposAddresses.resize(count);
+  dofAddresses.resize(count);
+  ctrlIndices.resize(count);
+  isHinge.resize(count);
+  positions.resize(count);
+  outputs.resize(count);
+  for(std::size_t i = 0; i < count; ++i)
+  {
+    const int jointIndex = motors[i]->joint->jointIndex;
+    ASSERT(model->jnt_type[jointIndex] == mjJNT_HINGE || model->jnt_type[jointIndex] == mjJNT_SLIDE);
+    qposAddresses[i] = model->jnt_qposadr[jointIndex];
+    dofAddresses[i] = model->jnt_dofadr[jointIndex];
+    ctrlIndices[i] = motors[i]->ctrlIndex;
+    isHinge[i] = model->jnt_type[jointIndex] == mjJNT_HINGE;
+
+    Simulation::simulation->model->dof_damping[dofAddresses[i]] = 0.01f;
+    Simulation::simulation->model->dof_armature[dofAddresses[i]] = 0.01f;
+    Simulation::simulation->model->dof_frictionloss[dofAddresses[i]] = 0.0f;
+  }
+  initialized = true;
+}
+
+void ServoMotorBank::act()
+{
+  if(motors.empty())
+    return;
+  if(!initialized)
+    initialize();
+
+  // Determine the setpoints that are executed in this step.
+  std::copy(targets.begin(), targets.end(), setpoints.begin());
+  for(ServoMotor* motor : delayedMotors)
+    motor->act();
+
+  // Gather the joint states.
+  mjData* data = Simulation::simulation->data;
+  const std::size_t count = motors.size();
+  for(std::size_t i = 0; i < count; ++i)
+  {
+    float position = static_cast<float>(data->qpos[qposAddresses[i]]);
+    if(isHinge[i])
+      position = lastPositions[i] + normalize(position - normalize(lastPositions[i]));
+    positions[i] = position;
+    outputs[i] = static_cast<float>(data->qvel[dofAddresses[i]]);
+  }
+
+  // Evaluate all controllers. This loop has neither branches nor indirections, so it is vectorized by the compiler.
+  const float* const setpoints = this->setpoints.data();
+  const float* const positions = this->positions.data();
+  const float* const p = this->p.data();
+  const float* const d = this->d.data();
+  const float* const maxForces = this->maxForces.data();
+  const float* const velocityLowPassFactors = this->velocityLowPassFactors.data();
+  float* const velocities = this->velocities.data();
+  float* const lastPositions = this->lastPositions.data();
+  float* const outputs = this->outputs.data();
+  for(std::size_t i = 0; i < count; ++i)
+  {
+    velocities[i] = outputs[i] * velocityLowPassFactors[i] + velocities[i] * (1.f - velocityLowPassFactors[i]);
+    const float output = p[i] * (setpoints[i] - positions[i]) - d[i] * velocities[i];
+    outputs[i] = std::max(-maxForces[i], std::min(output, maxForces[i]));
+    lastPositions[i] = positions[i];
+  }
+
+  // Write the results to MuJoCo. Puppets just follow their setpoints.
+  for(std::size_t i = 0; i < count; ++i)
+    if(isPuppet[i])
+    {
+      data->qpos[qposAddresses[i]] = targets[i];
+      data->qvel[dofAddresses[i]] = 0.;
+    }
+    else
+      data->ctrl[ctrlIndices[i]] = outputs[i];
+}
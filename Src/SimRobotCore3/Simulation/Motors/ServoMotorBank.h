@@ -0,0 +1,58 @@
+/**
+ * @file Simulation/Motors/ServoMotorBank.h
+ * Declaration of class ServoMotorBank
+ */
+
+#pragma once
+
+#include <vector>
+
+class ServoMotor;
+
+/**
+ * @class ServoMotorBank
+ * The state of all servo motors of a scene, stored as struct of arrays, so that the
+ * PD controllers of all motors can be evaluated in a single (vectorizable) loop.
+ */
+class ServoMotorBank
+{
+public:
+  std::vector<ServoMotor*> motors; /**< The motors in the order of their indices */
+  std::vector<ServoMotor*> delayedMotors; /**< The motors whose setpoints are applied with a delay */
+
+  std::vector<float> targets; /**< The setpoints requested via \c setValue */
+  std::vector<float> setpoints; /**< The setpoints that are currently executed (i.e. delayed if necessary) */
+  std::vector<float> minTargets; /**< The lower limit of the setpoints */
+  std::vector<float> maxTargets; /**< The upper limit of the setpoints */
+  std::vector<float> p; /**< The proportional gains */
+  std::vector<float> d; /**< The derivative gains */
+  std::vector<float> maxForces; /**< The maximum absolute controller outputs */
+  std::vector<float> velocityLowPassFactors; /**< The factors of the low-pass filters for the joint velocities */
+  std::vector<float> velocities; /**< The filtered joint velocities */
+  std::vector<float> lastPositions; /**< The joint positions in the previous step (used to unwrap hinge angles) */
+  std::vector<unsigned char> isPuppet; /**< Whether the joint positions are set directly instead of being controlled */
+
+  /**
+   * Adds a motor to the bank
+   * @param motor The motor
+   * @param setpoint The initial setpoint
+   * @param lastPosition The initial joint position
+   * @return The index of the motor in the arrays of the bank
+   */
+  unsigned int add(ServoMotor& motor, float setpoint, float lastPosition);
+
+  /** Updates the delayed setpoints, evaluates the controllers and writes their outputs to MuJoCo */
+  void act();
+
+private:
+  std::vector<int> qposAddresses; /**< The addresses of the joint positions in \c mjData::qpos */
+  std::vector<int> dofAddresses; /**< The addresses of the joint velocities in \c mjData::qvel */
+  std::vector<int> ctrlIndices; /**< The indices of the actuators in \c mjData::ctrl */
+  std::vector<unsigned char> isHinge; /**< Whether the joint is a hinge (i.e. its angle must be unwrapped) */
+  std::vector<float> positions; /**< The unwrapped joint positions in the current step */
+  std::vector<float> outputs; /**< The controller outputs in the current step */
+  bool initialized = false; /**< Whether the addresses have been determined */
+
+  /** Determines the addresses in MuJoCo's arrays once the model has been compiled */
+  void initialize();
+};
@@ -93,6 +93,13 @@ void VelocityMotor::PositionSensor::updateValue()
     data.floatValue = lastPos + normalize(data.floatValue - normalize(lastPos));
 }
 
+Sensor::Port::DataSource VelocityMotor::PositionSensor::getDataSource(int& address) const
+{
+  // MuJoCo does not wrap hinge angles and lastPos follows the joint, so updateValue yields the raw value anyway.
+  address = Simulation::simulation->model->jnt_qposadr[joint->jointIndex];
+  return qpos;
+}
+
 bool VelocityMotor::PositionSensor::getMinAndMax(float& min, float& max) const
 {
   const Axis::Deflection* deflection = joint->axis->deflection;
@@ -110,6 +117,12 @@ void VelocityMotor::VelocitySensor::updateValue()
   data.floatValue = static_cast<float>(Simulation::simulation->data->qvel[Simulation::simulation->model->jnt_dofadr[joint->jointIndex]]);
 }
 
+Sensor::Port::DataSource VelocityMotor::VelocitySensor::getDataSource(int& address) const
+{
+  address = Simulation::simulation->model->jnt_dofadr[joint->jointIndex];
+  return qvel;
+}
+
 bool VelocityMotor::VelocitySensor::getMinAndMax(float& min, float& max) const
 {
   min = -maxVelocity;
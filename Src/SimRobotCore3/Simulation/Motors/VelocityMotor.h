@@ -17,6 +17,7 @@
 class VelocityMotor : public Motor
 {
 public:
+  float setpoint = 0.f;
   float maxVelocity = 0.f;
   float maxForce = 0.f;
 
@@ -36,6 +37,7 @@ private:
 
     //API
     void updateValue() override;
+    DataSource getDataSource(int& address) const override;
     bool getMinAndMax(float& min, float& max) const override;
   } positionSensor;
 
@@ -51,6 +53,7 @@ private:
 
     //API
     void updateValue() override;
+    DataSource getDataSource(int& address) const override;
     bool getMinAndMax(float& min, float& max) const override;
   } velocitySensor;
 
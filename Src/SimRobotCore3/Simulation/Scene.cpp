@@ -8,21 +8,43 @@
 #include "CoreModule.h"
 #include "Platform/Assert.h"
 #include "Simulation/Actuators/Actuator.h"
+#include "Simulation/Actuators/ActuatorGroup.h"
 #include "Simulation/Body.h"
+#include "Simulation/Sensors/SensorGroup.h"
 #include "Simulation/Simulation.h"
+#include <mujoco/mujoco.h>
+#include <algorithm>
+#include <limits>
+#include <utility>
 
-void Scene::updateTransformations()
+void Scene::updateTransformations(float interpolation)
 {
-  if(lastTransformationUpdateStep != Simulation::simulation->simulationStep)
+  if(Simulation::simulation->previousXpos.empty())
+    interpolation = 1.f;
+  if(lastTransformationUpdateStep != Simulation::simulation->simulationStep || lastTransformationInterpolation != interpolation || !transformationsValid)
   {
     for(Body* body : bodies)
-      body->updateTransformation();
+      body->updateTransformation(interpolation);
+
+    // Model matrices are only updated once per step (for all renderers and sensors), but the poses changed within this step.
+    if(lastTransformationUpdateStep == Simulation::simulation->simulationStep)
+      Simulation::simulation->graphicsContext.invalidateModelMatrices();
+
     lastTransformationUpdateStep = Simulation::simulation->simulationStep;
+    lastTransformationInterpolation = interpolation;
+    transformationsValid = true;
   }
 }
 
+void Scene::invalidateTransformations()
+{
+  transformationsValid = false;
+  ++poseChanges;
+}
+
 void Scene::updateActuators()
 {
+  servoMotors.act();
   for(Actuator::Port* actuator : actuators)
     actuator->act();
 }
@@ -102,3 +124,150 @@ bool Scene::registerDrawingManager(SimRobotCore3::Controller3DDrawingManager& ma
   drawingManager = &manager;
   return true;
 }
+
+SimRobotCore3::SensorGroup* Scene::createSensorGroup(SimRobotCore3::SensorPort* const* sensors, unsigned int count)
+{
+  return SensorGroup::create(sensors, count);
+}
+
+SimRobotCore3::ActuatorGroup* Scene::createActuatorGroup(SimRobotCore3::ActuatorPort* const* actuators, unsigned int count)
+{
+  return new ActuatorGroup(actuators, count);
+}
+
+void Scene::updateBodyBounds()
+{
+  const mjModel* model = Simulation::simulation->model;
+  const mjData* data = Simulation::simulation->data;
+  if(bodyBoundsStep == Simulation::simulation->simulationStep && !bodyBounds.empty())
+    return;
+  bodyBoundsStep = Simulation::simulation->simulationStep;
+
+  // The assignment of geoms to root bodies never changes, so it is only determined once.
+  if(queryBodies.empty())
+  {
+    queryBodies.assign(bodies.begin(), bodies.end());
+    geometryQueryBodies.assign(model->ngeom, -1);
+    for(int i = 0; i < model->ngeom; ++i)
+    {
+      const int bodyIndex = model->geom_bodyid[i];
+      const Body* body = bodyIndex > 0 ? Simulation::simulation->bodyMap[bodyIndex] : nullptr;
+      if(!body)
+        continue;
+      const auto entry = std::find(queryBodies.begin(), queryBodies.end(), body->rootBody);
+      if(entry != queryBodies.end())
+        geometryQueryBodies[i] = static_cast<int>(entry - queryBodies.begin());
+    }
+    bodyBounds.resize(queryBodies.size());
+  }
+
+  // Enclose the bounding spheres of all geoms of each root body.
+  for(BodyBounds& bounds : bodyBounds)
+  {
+    bounds.min = Vector3f::Constant(std::numeric_limits<float>::max());
+    bounds.max = Vector3f::Constant(-std::numeric_limits<float>::max());
+  }
+  for(int i = 0; i < model->ngeom; ++i)
+    if(const int index = geometryQueryBodies[i]; index >= 0)
+    {
+      const Vector3f center = Vector3f(static_cast<float>(data->geom_xpos[i * 3]), static_cast<float>(data->geom_xpos[i * 3 + 1]), static_cast<float>(data->geom_xpos[i * 3 + 2]));
+      const Vector3f radius = Vector3f::Constant(static_cast<float>(model->geom_rbound[i]));
+      BodyBounds& bounds = bodyBounds[index];
+      bounds.min = bounds.min.cwiseMin(center - radius);
+      bounds.max = bounds.max.cwiseMax(center + radius);
+    }
+}
+
+Vector3f Scene::getPosition(const Body& body)
+{
+  const mjtNum* position = Simulation::simulation->data->xpos + body.bodyIndex * 3;
+  return Vector3f(static_cast<float>(position[0]), static_cast<float>(position[1]), static_cast<float>(position[2]));
+}
+
+void Scene::queryAABB(const float* min, const float* max, QList<SimRobotCore3::Body*>& bodies)
+{
+  updateBodyBounds();
+  bodies.clear();
+  const Vector3f queryMin(min[0], min[1], min[2]);
+  const Vector3f queryMax(max[0], max[1], max[2]);
+  for(std::size_t i = 0; i < bodyBounds.size(); ++i)
+    if((bodyBounds[i].min.array() <= queryMax.array()).all() && (bodyBounds[i].max.array() >= queryMin.array()).all())
+      bodies.append(queryBodies[i]);
+}
+
+void Scene::queryRadius(const float* center, float radius, QList<SimRobotCore3::Body*>& bodies)
+{
+  updateBodyBounds();
+  bodies.clear();
+  const Vector3f queryCenter(center[0], center[1], center[2]);
+  const float radiusSqr = radius * radius;
+  for(std::size_t i = 0; i < queryBodies.size(); ++i)
+    if(bodyBounds[i].min.x() <= bodyBounds[i].max.x() && (getPosition(*queryBodies[i]) - queryCenter).squaredNorm() <= radiusSqr)
+      bodies.append(queryBodies[i]);
+}
+
+void Scene::queryNearest(const float* point, unsigned int count, QList<SimRobotCore3::Body*>& bodies)
+{
+  updateBodyBounds();
+  bodies.clear();
+  const Vector3f queryPoint(point[0], point[1], point[2]);
+  std::vector<std::pair<float, Body*>> candidates;
+  candidates.reserve(queryBodies.size());
+  for(std::size_t i = 0; i < queryBodies.size(); ++i)
+    if(bodyBounds[i].min.x() <= bodyBounds[i].max.x())
+      candidates.emplace_back((getPosition(*queryBodies[i]) - queryPoint).squaredNorm(), queryBodies[i]);
+  const auto end = candidates.begin() + std::min(static_cast<std::size_t>(count), candidates.size());
+  std::partial_sort(candidates.begin(), end, candidates.end(), [](const auto& a, const auto& b) {return a.first < b.first;});
+  for(auto candidate = candidates.begin(); candidate != end; ++candidate)
+    bodies.append(candidate->second);
+}
+
+SimRobotCore3::Body* Scene::queryRay(const float* origin, const float* direction, float maxDistance, float* distance)
+{
+  const Vector3f queryDirection(direction[0], direction[1], direction[2]);
+  if(queryDirection.squaredNorm() == 0.f || maxDistance <= 0.f)
+    return nullptr;
+  const Vector3f normalizedDirection = queryDirection.normalized();
+  mjtNum pnt[3], vec[3];
+  mju_f2n(pnt, origin, 3);
+  mju_f2n(vec, normalizedDirection.data(), 3);
+  int geometryIndex = -1;
+  const mjtNum hitDistance = mj_ray(Simulation::simulation->model, Simulation::simulation->data, pnt, vec, nullptr, 1, -1, &geometryIndex);
+  if(hitDistance < 0 || hitDistance > maxDistance)
+    return nullptr;
+  if(distance)
+    *distance = static_cast<float>(hitDistance);
+  const int bodyIndex = Simulation::simulation->model->geom_bodyid[geometryIndex];
+  const Body* body = bodyIndex > 0 ? Simulation::simulation->bodyMap[bodyIndex] : nullptr;
+  return body ? body->rootBody : nullptr;
+}
+
+bool Scene::startRecording(const QString& fileName)
+{
+  return Simulation::simulation->startRecording(fileName.toStdString());
+}
+
+void Scene::stopRecording()
+{
+  Simulation::simulation->stopRecording();
+}
+
+bool Scene::startReplay(const QString& fileName)
+{
+  return Simulation::simulation->startReplay(fileName.toStdString());
+}
+
+void Scene::stopReplay()
+{
+  Simulation::simulation->stopReplay();
+}
+
+bool Scene::seekReplay(unsigned int frame)
+{
+  return Simulation::simulation->replayer.isOpen() && Simulation::simulation->seekReplay(frame);
+}
+
+unsigned int Scene::getReplayLength() const
+{
+  return Simulation::simulation->replayer.getNumOfFrames();
+}
@@ -7,13 +7,16 @@
 #pragma once
 
 #include "SimRobotCore3.h"
+#include "ControllerBridge.h"
 #include "Simulation/Actuators/Actuator.h"
 #include "Simulation/Appearances/Appearance.h"
 #include "Simulation/GraphicalObject.h"
+#include "Simulation/Motors/ServoMotorBank.h"
 #include "Simulation/PhysicalObject.h"
 #include <list>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 class Body;
 class Light;
@@ -27,8 +30,12 @@ class Scene : public PhysicalObject, public GraphicalObject, public SimRobotCore
 public:
 
   std::string controller; /**< The name of the controller library. */
+  ControllerBridge::Mode bridgeMode = ControllerBridge::off; /**< Whether and how ports are exposed to controllers in other processes. */
+  unsigned int bridgeTimeout = 1000; /**< The time in ms to wait for an external controller in lockstep mode. */
   float color[4]; /**< The background (clear color) */
   float stepLength; /**< The length of a simulation step */
+  float realTimeFactor = 0.f; /**< How fast the simulated time advances relative to the real time (0 means one step per update) */
+  unsigned int maxSubSteps = 10; /**< The maximum number of steps per update if the simulation runs in real time */
   float gravity; /**< The gravity in the simulated world */
   int contactMode = 0; /**< The default contact mode for contacts between bodies. TODO unused */
   bool detectBodyCollisions; /**< Whether to detect collision between different bodies. TODO unused */
@@ -36,6 +43,7 @@ public:
   SimRobotCore3::Controller3DDrawingManager* drawingManager = nullptr; /**< The manager for 3D controller drawings */
   std::list<Body*> bodies; /**< List of bodies without a parent body */
   std::list<Actuator::Port*> actuators; /**< List of actuators that need to do something in every simulation step */
+  ServoMotorBank servoMotors; /**< The state of all servo motors, which are updated together */
   std::list<Light*> lights; /**< List of scene lights */
 
   /** Default constructor */
@@ -45,9 +53,18 @@ public:
     color[3] = 1.f;
   }
 
-  /** Updates the transformation of movable objects */
-  void updateTransformations();
+  /**
+   * Updates the transformation of movable objects
+   * @param interpolation Where to place the objects between the previous (0) and the current step (1)
+   */
+  void updateTransformations(float interpolation = 1.f);
   unsigned int lastTransformationUpdateStep = 0;
+  float lastTransformationInterpolation = 1.f; /**< The interpolation the transformations were last updated with */
+  bool transformationsValid = true; /**< Whether the poses did not change since the transformations were last updated */
+  unsigned int poseChanges = 0; /**< Counts how often poses changed without a simulation step, so that views can tell that they are outdated */
+
+  /** Notes that poses changed without a simulation step (e.g. because a body was dragged), so all transformations have to be updated */
+  void invalidateTransformations();
 
   /** Updates all actuators that need to do something for each simulation step */
   void updateActuators();
@@ -72,6 +89,28 @@ public:
   void drawPhysics(GraphicsContext& graphicsContext, unsigned int flags) const override;
 
 private:
+  /** The bounds of a root body (including all bodies attached to it) */
+  struct BodyBounds
+  {
+    Vector3f min; /**< The minimum corner of the axis-aligned box around all geometries */
+    Vector3f max; /**< The maximum corner of the axis-aligned box around all geometries */
+  };
+
+  std::vector<Body*> queryBodies; /**< The root bodies that can be found by spatial queries */
+  std::vector<int> geometryQueryBodies; /**< The index into \c queryBodies for each MuJoCo geom (-1 for static geoms) */
+  std::vector<BodyBounds> bodyBounds; /**< The bounds of each of the \c queryBodies (empty, i.e. min > max, if a body has no geoms) */
+  unsigned int bodyBoundsStep = 0xffffffff; /**< The simulation step in which \c bodyBounds were computed */
+
+  /** Computes the bounds of all root bodies from the bounding spheres of their geoms (once per simulation step) */
+  void updateBodyBounds();
+
+  /**
+   * Returns the position of a root body in the current simulation state
+   * @param body The root body
+   * @return The position of the body
+   */
+  static Vector3f getPosition(const Body& body);
+
   /**
    * Visits controller drawings of graphical children
    * @param accept The functor to apply to every child
@@ -98,4 +137,16 @@ private:
   double getTime() const override;
   unsigned int getFrameRate() const override;
   bool registerDrawingManager(SimRobotCore3::Controller3DDrawingManager& manager) override;
+  SimRobotCore3::SensorGroup* createSensorGroup(SimRobotCore3::SensorPort* const* sensors, unsigned int count) override;
+  SimRobotCore3::ActuatorGroup* createActuatorGroup(SimRobotCore3::ActuatorPort* const* actuators, unsigned int count) override;
+  void queryAABB(const float* min, const float* max, QList<SimRobotCore3::Body*>& bodies) override;
+  void queryRadius(const float* center, float radius, QList<SimRobotCore3::Body*>& bodies) override;
+  void queryNearest(const float* point, unsigned int count, QList<SimRobotCore3::Body*>& bodies) override;
+  SimRobotCore3::Body* queryRay(const float* origin, const float* direction, float maxDistance, float* distance) override;
+  bool startRecording(const QString& fileName) override;
+  void stopRecording() override;
+  bool startReplay(const QString& fileName) override;
+  void stopReplay() override;
+  bool seekReplay(unsigned int frame) override;
+  unsigned int getReplayLength() const override;
 };
@@ -26,6 +26,7 @@ Accelerometer::Accelerometer()
 void Accelerometer::createPhysics(GraphicsContext& graphicsContext)
 {
   Sensor::createPhysics(graphicsContext);
+  setUpdateRate(sensor);
 
   const char* siteName = Simulation::simulation->getName(mjOBJ_SITE, "Accelerometer");
 
@@ -68,3 +69,9 @@ void Accelerometer::AccelerometerSensor::updateValue()
   ASSERT(Simulation::simulation->model->sensor_dim[sensorIndex] == 3);
   mju_n2f(linearAcc, Simulation::simulation->data->sensordata + Simulation::simulation->model->sensor_adr[sensorIndex], 3);
 }
+
+Sensor::Port::DataSource Accelerometer::AccelerometerSensor::getDataSource(int& address) const
+{
+  address = Simulation::simulation->model->sensor_adr[sensorIndex];
+  return sensordata;
+}
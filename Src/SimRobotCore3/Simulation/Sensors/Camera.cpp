@@ -30,6 +30,7 @@ Camera::~Camera()
 void Camera::createPhysics(GraphicsContext& graphicsContext)
 {
   Sensor::createPhysics(graphicsContext);
+  setUpdateRate(sensor);
 
   sensor.dimensions.append(imageWidth);
   sensor.dimensions.append(imageHeight);
@@ -109,7 +110,7 @@ void Camera::CameraSensor::updateValue()
 
 bool Camera::CameraSensor::renderCameraImages(SimRobotCore3::SensorPort** cameras, unsigned int count)
 {
-  if(lastSimulationStep == Simulation::simulation->simulationStep)
+  if(lastSimulationStep == getSampleStep())
     return true;
 
   // allocate buffer
@@ -120,7 +121,7 @@ bool Camera::CameraSensor::renderCameraImages(SimRobotCore3::SensorPort** camera
   for(unsigned int i = 0; i < count; ++i)
   {
     CameraSensor* sensor = static_cast<CameraSensor*>(cameras[i]);
-    if(sensor && sensor->lastSimulationStep != Simulation::simulation->simulationStep &&
+    if(sensor && sensor->lastSimulationStep != sensor->getSampleStep() &&
        sensor->camera->imageWidth == imageWidth && sensor->camera->imageHeight == imageHeight)
       ++imagesOfCurrentSize;
   }
@@ -147,7 +148,7 @@ bool Camera::CameraSensor::renderCameraImages(SimRobotCore3::SensorPort** camera
   for(unsigned int i = 0; i < count; ++i)
   {
     CameraSensor* sensor = static_cast<CameraSensor*>(cameras[i]);
-    if(sensor && sensor->lastSimulationStep != Simulation::simulation->simulationStep &&
+    if(sensor && sensor->lastSimulationStep != sensor->getSampleStep() &&
        sensor->camera->imageWidth == imageWidth && sensor->camera->imageHeight == imageHeight)
     {
       // setup camera position
@@ -166,7 +167,7 @@ bool Camera::CameraSensor::renderCameraImages(SimRobotCore3::SensorPort** camera
       graphicsContext.finishRendering();
 
       sensor->data.byteArray = currentBufferPos;
-      sensor->lastSimulationStep = Simulation::simulation->simulationStep;
+      sensor->lastSimulationStep = sensor->getSampleStep();
 
       currentHorizontalPos += imageHeight;
       currentBufferPos += imageSize;
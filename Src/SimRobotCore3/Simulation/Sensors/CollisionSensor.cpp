@@ -46,6 +46,7 @@ void CollisionSensor::createPhysics(GraphicsContext& graphicsContext)
     registerCollisionCallback(parentBody->physicalDrawings);
 
   Sensor::createPhysics(graphicsContext);
+  setUpdateRate(sensor);
 }
 
 void CollisionSensor::registerCollisionCallback(std::list<::PhysicalObject*>& geometries)
@@ -37,6 +37,7 @@ DepthImageSensor::~DepthImageSensor()
 void DepthImageSensor::createPhysics(GraphicsContext& graphicsContext)
 {
   Sensor::createPhysics(graphicsContext);
+  setUpdateRate(sensor);
 
   sensor.imageBuffer = new float[imageWidth * imageHeight];
   sensor.renderHeight = imageHeight;
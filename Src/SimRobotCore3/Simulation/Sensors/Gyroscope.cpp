@@ -25,6 +25,7 @@ Gyroscope::Gyroscope()
 void Gyroscope::createPhysics(GraphicsContext& graphicsContext)
 {
   Sensor::createPhysics(graphicsContext);
+  setUpdateRate(sensor);
 
   const char* siteName = Simulation::simulation->getName(mjOBJ_SITE, "Gyroscope");
 
@@ -67,3 +68,9 @@ void Gyroscope::GyroscopeSensor::updateValue()
   ASSERT(Simulation::simulation->model->sensor_dim[sensorIndex] == 3);
   mju_n2f(angularVel, Simulation::simulation->data->sensordata + Simulation::simulation->model->sensor_adr[sensorIndex], 3);
 }
+
+Sensor::Port::DataSource Gyroscope::GyroscopeSensor::getDataSource(int& address) const
+{
+  address = Simulation::simulation->model->sensor_adr[sensorIndex];
+  return sensordata;
+}
@@ -34,6 +34,7 @@ private:
 
     /** Update the sensor value. Is called when required. */
     void updateValue() override;
+    DataSource getDataSource(int& address) const override;
 
     //API
     bool getMinAndMax(float&, float&) const override {return false;}
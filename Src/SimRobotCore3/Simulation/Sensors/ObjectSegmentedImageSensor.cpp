@@ -54,6 +54,7 @@ ObjectSegmentedImageSensor::~ObjectSegmentedImageSensor()
 void ObjectSegmentedImageSensor::createPhysics(GraphicsContext& graphicsContext)
 {
   Sensor::createPhysics(graphicsContext);
+  setUpdateRate(sensor);
 
   sensor.dimensions.append(imageWidth);
   sensor.dimensions.append(imageHeight);
@@ -148,7 +149,7 @@ void ObjectSegmentedImageSensor::ObjectSegmentedImageSensorPort::updateValue()
 
 bool ObjectSegmentedImageSensor::ObjectSegmentedImageSensorPort::renderCameraImages(SimRobotCore3::SensorPort** cameras, unsigned int count)
 {
-  if(lastSimulationStep == Simulation::simulation->simulationStep)
+  if(lastSimulationStep == getSampleStep())
     return true;
 
   // allocate buffer
@@ -159,7 +160,7 @@ bool ObjectSegmentedImageSensor::ObjectSegmentedImageSensorPort::renderCameraIma
   for(unsigned int i = 0; i < count; ++i)
   {
     ObjectSegmentedImageSensorPort* sensor = static_cast<ObjectSegmentedImageSensorPort*>(cameras[i]);
-    if(sensor && sensor->lastSimulationStep != Simulation::simulation->simulationStep &&
+    if(sensor && sensor->lastSimulationStep != sensor->getSampleStep() &&
        sensor->camera->imageWidth == imageWidth && sensor->camera->imageHeight == imageHeight)
       ++imagesOfCurrentSize;
   }
@@ -186,7 +187,7 @@ bool ObjectSegmentedImageSensor::ObjectSegmentedImageSensorPort::renderCameraIma
   for(unsigned int i = 0; i < count; ++i)
   {
     ObjectSegmentedImageSensorPort* sensor = static_cast<ObjectSegmentedImageSensorPort*>(cameras[i]);
-    if(sensor && sensor->lastSimulationStep != Simulation::simulation->simulationStep &&
+    if(sensor && sensor->lastSimulationStep != sensor->getSampleStep() &&
        sensor->camera->imageWidth == imageWidth && sensor->camera->imageHeight == imageHeight)
     {
       // setup camera position
@@ -213,7 +214,7 @@ bool ObjectSegmentedImageSensor::ObjectSegmentedImageSensorPort::renderCameraIma
       graphicsContext.finishRendering();
 
       sensor->data.byteArray = currentBufferPos;
-      sensor->lastSimulationStep = Simulation::simulation->simulationStep;
+      sensor->lastSimulationStep = sensor->getSampleStep();
 
       currentHorizontalPos += imageHeight;
       currentBufferPos += imageSize;
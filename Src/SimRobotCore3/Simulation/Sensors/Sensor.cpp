@@ -9,8 +9,11 @@
 #include "Graphics/GraphicsContext.h"
 #include "Platform/Assert.h"
 #include "SensorWidget.h"
+#include "Simulation/Scene.h"
 #include "Simulation/Simulation.h"
 #include "Tools/OpenGLTools.h"
+#include <algorithm>
+#include <cmath>
 
 void Sensor::createPhysics(GraphicsContext& graphicsContext)
 {
@@ -23,6 +26,15 @@ void Sensor::createPhysics(GraphicsContext& graphicsContext)
   graphicsContext.popModelMatrix();
 }
 
+void Sensor::setUpdateRate(Port& port) const
+{
+  if(rate <= 0.f)
+    return;
+  const float stepsPerUpdate = 1.f / (rate * Simulation::simulation->scene->stepLength);
+  port.updateInterval = std::max(1u, static_cast<unsigned int>(std::round(stepsPerUpdate)));
+  port.updatePhase = std::min(port.updateInterval - 1, static_cast<unsigned int>(phase * static_cast<float>(port.updateInterval)));
+}
+
 const QIcon* Sensor::Port::getIcon() const
 {
   return &CoreModule::module->sensorIcon;
@@ -33,12 +45,23 @@ SimRobot::Widget* Sensor::Port::createWidget()
   return new SensorWidget(this);
 }
 
+unsigned int Sensor::Port::getSampleStep() const
+{
+  const unsigned int step = Simulation::simulation->simulationStep;
+  if(updateInterval <= 1)
+    return step;
+  if(step < updatePhase)
+    return 0;
+  return step - (step - updatePhase) % updateInterval;
+}
+
 SimRobotCore3::SensorPort::Data Sensor::Port::getValue()
 {
-  if(lastSimulationStep != Simulation::simulation->simulationStep)
+  const unsigned int sampleStep = getSampleStep();
+  if(lastSimulationStep != sampleStep)
   {
     updateValue();
-    lastSimulationStep = Simulation::simulation->simulationStep;
+    lastSimulationStep = sampleStep;
   }
   return data;
 }
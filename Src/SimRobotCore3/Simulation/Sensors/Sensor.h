@@ -20,17 +20,47 @@ public:
   class Port : public SimRobotCore3::SensorPort
   {
   public:
+    /** The MuJoCo arrays that can directly contain sensor readings */
+    enum DataSource
+    {
+      noSource,
+      qpos,
+      qvel,
+      sensordata
+    };
+
     QString fullName; /**< The path name to the object in the scene graph */
     SensorType sensorType; /**< The data type of the sensor readings */
     Data data; /**< The sensor reading */
     QList<int> dimensions; /**< The dimensions of the sensor readings */
     QStringList descriptions; /**< A description for each sensor reading dimension */
     QString unit; /**< The unit of the sensor readings */
-    unsigned int lastSimulationStep = 0xffffffff; /**< The last time this sensor was computed. */
+    unsigned int lastSimulationStep = 0xffffffff; /**< The sample step (see \c getSampleStep) at which this sensor was computed. */
+    unsigned int updateInterval = 1; /**< The number of simulation steps between two sensor updates */
+    unsigned int updatePhase = 0; /**< The simulation step (modulo \c updateInterval) at which the sensor is updated */
+
+    /**
+     * Returns the simulation step to which the current sensor reading belongs, i.e. the last step
+     * in which the sensor was due for an update according to its update interval and phase.
+     * @return The simulation step
+     */
+    unsigned int getSampleStep() const;
 
     /** Update the sensor value. Is called when required. */
     virtual void updateValue() = 0;
 
+    /**
+     * Returns whether the readings of this sensor are plain values in one of MuJoCo's arrays,
+     * which allows to read them without calling \c updateValue.
+     * @param address Is set to the index of the first reading in that array
+     * @return The array or \c noSource
+     */
+    virtual DataSource getDataSource(int& address) const
+    {
+      static_cast<void>(address);
+      return noSource;
+    }
+
   private:
     // API
     const QString& getFullName() const override {return fullName;}
@@ -44,7 +74,16 @@ public:
     bool renderCameraImages(SimRobotCore3::SensorPort**, unsigned int) override {return false;}
   };
 
+  float rate = 0.f; /**< The update rate of the sensor in Hz (0 means every simulation step) */
+  float phase = 0.f; /**< The offset of the sensor updates as fraction of the update period */
+
 protected:
+  /**
+   * Sets the update interval and phase of a port of this sensor according to \c rate and \c phase
+   * @param port The port
+   */
+  void setUpdateRate(Port& port) const;
+
   /**
    * Creates the physical objects used by the OpenDynamicsEngine (ODE).
    * These are a geometry object for collision detection and/or a body,
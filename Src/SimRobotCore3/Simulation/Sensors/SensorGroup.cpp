@@ -0,0 +1,81 @@
+/**
+ * @file Simulation/Sensors/SensorGroup.cpp
+ * Implementation of class SensorGroup
+ */
+
+#include "SensorGroup.h"
+#include "Simulation/Simulation.h"
+#include <mujoco/mjdata.h>
+#include <algorithm>
+
+SensorGroup* SensorGroup::create(SimRobotCore3::SensorPort* const* sensors, unsigned int count)
+{
+  SensorGroup* group = new SensorGroup;
+  for(unsigned int i = 0; i < count; ++i)
+  {
+    Sensor::Port* port = dynamic_cast<Sensor::Port*>(sensors[i]);
+    if(!port || port->sensorType == SimRobotCore3::SensorPort::cameraSensor || port->sensorType == SimRobotCore3::SensorPort::noSensor)
+    {
+      delete group;
+      return nullptr;
+    }
+
+    unsigned int numOfValues = 1;
+    if(port->sensorType == SimRobotCore3::SensorPort::floatArraySensor)
+      for(int dimension : port->dimensions)
+        numOfValues *= static_cast<unsigned int>(dimension);
+
+    // Sensors that are only updated at a lower rate must return their cached readings.
+    int address;
+    const Sensor::Port::DataSource source = port->updateInterval == 1 ? port->getDataSource(address) : Sensor::Port::noSource;
+    Gather* gather = source == Sensor::Port::qpos ? &group->qpos :
+                     source == Sensor::Port::qvel ? &group->qvel :
+                     source == Sensor::Port::sensordata ? &group->sensordata : nullptr;
+    if(gather)
+      for(unsigned int j = 0; j < numOfValues; ++j)
+      {
+        gather->addresses.push_back(address + static_cast<int>(j));
+        gather->offsets.push_back(group->size + j);
+      }
+    else
+    {
+      group->ports.push_back(port);
+      group->portOffsets.push_back(group->size);
+      group->portSizes.push_back(numOfValues);
+    }
+    group->size += numOfValues;
+  }
+  return group;
+}
+
+void SensorGroup::read(float* values)
+{
+  const mjData* simulationData = Simulation::simulation->data;
+  for(std::size_t i = 0, count = qpos.addresses.size(); i < count; ++i)
+    values[qpos.offsets[i]] = static_cast<float>(simulationData->qpos[qpos.addresses[i]]);
+  for(std::size_t i = 0, count = qvel.addresses.size(); i < count; ++i)
+    values[qvel.offsets[i]] = static_cast<float>(simulationData->qvel[qvel.addresses[i]]);
+  for(std::size_t i = 0, count = sensordata.addresses.size(); i < count; ++i)
+    values[sensordata.offsets[i]] = static_cast<float>(simulationData->sensordata[sensordata.addresses[i]]);
+
+  for(std::size_t i = 0, count = ports.size(); i < count; ++i)
+  {
+    Sensor::Port* port = ports[i];
+    float* value = values + portOffsets[i];
+    const SimRobotCore3::SensorPort::Data data = static_cast<SimRobotCore3::SensorPort*>(port)->getValue();
+    switch(port->sensorType)
+    {
+      case SimRobotCore3::SensorPort::boolSensor:
+        *value = data.boolValue ? 1.f : 0.f;
+        break;
+      case SimRobotCore3::SensorPort::floatSensor:
+        *value = data.floatValue;
+        break;
+      case SimRobotCore3::SensorPort::floatArraySensor:
+        std::copy(data.floatArray, data.floatArray + portSizes[i], value);
+        break;
+      default:
+        break;
+    }
+  }
+}
@@ -0,0 +1,48 @@
+/**
+ * @file Simulation/Sensors/SensorGroup.h
+ * Declaration of class SensorGroup
+ */
+
+#pragma once
+
+#include "SimRobotCore3.h"
+#include "Simulation/Sensors/Sensor.h"
+#include <vector>
+
+/**
+ * @class SensorGroup
+ * A set of sensors that are read together. Readings that are plain values in MuJoCo's
+ * \c qpos, \c qvel or \c sensordata arrays are gathered through precomputed address tables.
+ * All other sensors are read through \c Sensor::Port::getValue.
+ */
+class SensorGroup : public SimRobotCore3::SensorGroup
+{
+public:
+  /**
+   * Creates a sensor group
+   * @param sensors The sensors of the group
+   * @param count The number of sensors
+   * @return The group or \c nullptr if a sensor is not supported
+   */
+  static SensorGroup* create(SimRobotCore3::SensorPort* const* sensors, unsigned int count);
+
+private:
+  /** A table of values that are copied from one of MuJoCo's arrays */
+  struct Gather
+  {
+    std::vector<int> addresses; /**< The indices of the values in the MuJoCo array */
+    std::vector<unsigned int> offsets; /**< The indices of the values in the output buffer */
+  };
+
+  Gather qpos; /**< Values gathered from \c mjData::qpos */
+  Gather qvel; /**< Values gathered from \c mjData::qvel */
+  Gather sensordata; /**< Values gathered from \c mjData::sensordata */
+  std::vector<Sensor::Port*> ports; /**< Sensors that are read through \c getValue */
+  std::vector<unsigned int> portOffsets; /**< The indices of the first value of each sensor in \c ports in the output buffer */
+  std::vector<unsigned int> portSizes; /**< The number of values of each sensor in \c ports */
+  unsigned int size = 0; /**< The number of values in the output buffer */
+
+  //API
+  unsigned int getSize() const override {return size;}
+  void read(float* values) override;
+};
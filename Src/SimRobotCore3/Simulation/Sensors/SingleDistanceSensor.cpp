@@ -19,6 +19,7 @@ SingleDistanceSensor::SingleDistanceSensor()
 void SingleDistanceSensor::createPhysics(GraphicsContext& graphicsContext)
 {
   Sensor::createPhysics(graphicsContext);
+  setUpdateRate(sensor);
 
   sensor.min = min;
   sensor.max = max;
@@ -13,10 +13,19 @@
 #include "Platform/System.h"
 #include "Simulation/Body.h"
 #include "Simulation/Geometries/Geometry.h"
+#include "Simulation/Geometries/MeshGeometry.h"
 #include "Simulation/Scene.h"
 #include <mujoco/mujoco.h>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <functional>
 
 Simulation* Simulation::simulation = nullptr;
 
@@ -33,6 +42,8 @@ Simulation::~Simulation()
   for(ElementCore3* element : elements)
     delete element;
 
+  if(recordCheckData)
+    mj_deleteData(recordCheckData);
   if(data)
     mj_deleteData(data);
   if(model)
@@ -49,6 +60,7 @@ bool Simulation::loadFile(const std::string& filename, std::list<std::string>& e
   ASSERT(!scene);
   ASSERT(elements.empty());
 
+  const unsigned int startTime = System::getTime();
   ParserCore3 parser;
   if(!parser.parse(filename, errors))
   {
@@ -90,10 +102,21 @@ bool Simulation::loadFile(const std::string& filename, std::list<std::string>& e
 
   worldBody = nullptr;
 
-  model = mj_compile(spec, nullptr);
+  // Compiling the model dominates the loading time of large scenes, so try to reuse the model from the last start.
+  const std::string cacheFileName = getModelCacheFileName(parser.getFileNames());
+  if(cacheFileName.empty() || !loadCachedModel(cacheFileName))
+  {
+    model = mj_compile(spec, nullptr);
 
-  if(!model)
-    errors.push_back(mjs_getError(spec));
+    if(!model)
+      errors.push_back(mjs_getError(spec));
+    else
+    {
+      VERIFY(resolveNames());
+      if(!cacheFileName.empty())
+        saveCachedModel(cacheFileName);
+    }
+  }
 
   mj_deleteSpec(spec);
   spec = nullptr;
@@ -106,19 +129,8 @@ bool Simulation::loadFile(const std::string& filename, std::list<std::string>& e
 
   mj_kinematics(model, data);
 
-  bodyMap.resize(model->nbody);
-  geometryMap.resize(model->ngeom);
-  for(auto& name : names)
-  {
-    const int id = mj_name2id(model, name.type, name.name.c_str());
-    ASSERT(id >= 0);
-    if(name.type == mjOBJ_BODY)
-      bodyMap[id] = static_cast<Body*>(name.object);
-    else if(name.type == mjOBJ_GEOM)
-      geometryMap[id] = static_cast<Geometry*>(name.object);
-    if(name.indexPointer)
-      *(name.indexPointer) = id;
-  }
+  for(MeshGeometry* meshGeometry : meshGeometries)
+    meshGeometry->createHullMesh(graphicsContext);
 
   graphicsContext.pushModelMatrixStack();
   scene->createGraphics(graphicsContext);
@@ -151,6 +163,7 @@ bool Simulation::loadFile(const std::string& filename, std::list<std::string>& e
 
   graphicsContext.compile();
 
+  loadTime = System::getTime() - startTime;
   return true;
 }
 
@@ -159,6 +172,18 @@ void Simulation::doSimulationStep()
   ++simulationStep;
   simulatedTime += scene->stepLength;
 
+  // Renderers interpolate between the poses of the previous and the current step.
+  if(scene->realTimeFactor > 0.f)
+  {
+    previousXpos.assign(data->xpos, data->xpos + model->nbody * 3);
+    previousXquat.assign(data->xquat, data->xquat + model->nbody * 4);
+  }
+
+  // The poses and sensor readings of this step are computed from the state before it is integrated,
+  // so this is the state from which a replay must compute them as well.
+  if(recorder.isOpen())
+    recordState();
+
   mj_step1(model, data);
 
   scene->updateActuators();
@@ -188,9 +213,158 @@ void Simulation::doSimulationStep()
     }
   }
 
+  if(recorder.isOpen())
+    writeState();
+
+  updateFrameRate();
+}
+
+unsigned int Simulation::getDueSteps()
+{
+  if(scene->realTimeFactor <= 0.f || !CoreModule::application->isSimRunning())
+  {
+    stepTimer.reset();
+    renderInterpolation = 1.f;
+    return 1;
+  }
+
+  const unsigned int steps = stepTimer.getDueSteps(scene->stepLength, scene->realTimeFactor, scene->maxSubSteps);
+  renderInterpolation = stepTimer.getInterpolation();
+  return steps;
+}
+
+bool Simulation::startRecording(const std::string& fileName)
+{
+  stopRecording();
+  return recorder.open(fileName, getStateSize() * sizeof(mjtNum));
+}
+
+void Simulation::stopRecording()
+{
+  if(recorder.isOpen())
+    recorder.close();
+}
+
+bool Simulation::startReplay(const std::string& fileName)
+{
+  stopReplay();
+  if(!replayer.open(fileName))
+    return false;
+  if(replayer.getFrameSize() != getStateSize() * sizeof(mjtNum) || !seekReplay(0))
+  {
+    replayer.close();
+    return false;
+  }
+  return true;
+}
+
+void Simulation::stopReplay()
+{
+  replayer.close();
+  replayFrame = 0;
+}
+
+bool Simulation::seekReplay(unsigned int frame)
+{
+  if(!replayState(frame))
+    return false;
+
+  // There is nothing to interpolate from after a jump.
+  if(scene->realTimeFactor > 0.f)
+  {
+    previousXpos.assign(data->xpos, data->xpos + model->nbody * 3);
+    previousXquat.assign(data->xquat, data->xquat + model->nbody * 4);
+  }
+  replayFrame = frame + 1;
+
+  // The poses changed even if the jump happened to end at the current step.
+  scene->invalidateTransformations();
+  return true;
+}
+
+void Simulation::doReplayStep()
+{
+  if(replayFrame >= replayer.getNumOfFrames())
+    return;
+
+  if(scene->realTimeFactor > 0.f)
+  {
+    previousXpos.assign(data->xpos, data->xpos + model->nbody * 3);
+    previousXquat.assign(data->xquat, data->xquat + model->nbody * 4);
+  }
+
+  if(replayState(replayFrame))
+    ++replayFrame;
+
   updateFrameRate();
 }
 
+std::size_t Simulation::getStateSize() const
+{
+  return 2 + model->nq + model->nv + model->na + model->nmocap * 7 + model->nsensordata;
+}
+
+void Simulation::recordState()
+{
+  state.resize(getStateSize());
+  mjtNum* value = state.data();
+  *value++ = simulationStep;
+  *value++ = simulatedTime;
+  value = std::copy(data->qpos, data->qpos + model->nq, value);
+  value = std::copy(data->qvel, data->qvel + model->nv, value);
+  value = std::copy(data->act, data->act + model->na, value);
+  value = std::copy(data->mocap_pos, data->mocap_pos + model->nmocap * 3, value);
+  std::copy(data->mocap_quat, data->mocap_quat + model->nmocap * 4, value);
+}
+
+void Simulation::writeState()
+{
+  std::copy(data->sensordata, data->sensordata + model->nsensordata, state.end() - model->nsensordata);
+
+#ifndef NDEBUG
+  // Replaying the state must show the bodies exactly where they are now.
+  if(!recordCheckData)
+    recordCheckData = mj_makeData(model);
+  applyState(state.data() + 2, *recordCheckData);
+  ASSERT(std::equal(data->xpos, data->xpos + model->nbody * 3, recordCheckData->xpos));
+  ASSERT(std::equal(data->xquat, data->xquat + model->nbody * 4, recordCheckData->xquat));
+#endif
+
+  recorder.write(state.data());
+}
+
+const mjtNum* Simulation::applyState(const mjtNum* value, mjData& target) const
+{
+  std::copy(value, value + model->nq, target.qpos);
+  value += model->nq;
+  std::copy(value, value + model->nv, target.qvel);
+  value += model->nv;
+  std::copy(value, value + model->na, target.act);
+  value += model->na;
+  std::copy(value, value + model->nmocap * 3, target.mocap_pos);
+  value += model->nmocap * 3;
+  std::copy(value, value + model->nmocap * 4, target.mocap_quat);
+  value += model->nmocap * 4;
+  mj_kinematics(model, &target);
+  return value;
+}
+
+bool Simulation::replayState(unsigned int frame)
+{
+  state.resize(getStateSize());
+  if(!replayer.read(frame, state.data()))
+    return false;
+
+  const mjtNum* value = state.data();
+  simulationStep = static_cast<unsigned int>(*value++);
+  simulatedTime = *value++;
+
+  // Only the poses are computed from the state, the sensor readings are taken from the log as they were.
+  value = applyState(value, *data);
+  std::copy(value, value + model->nsensordata, data->sensordata);
+  return true;
+}
+
 void Simulation::updateFrameRate()
 {
   const unsigned int currentTime = System::getTime();
@@ -205,6 +379,111 @@ void Simulation::updateFrameRate()
   }
 }
 
+std::string Simulation::getModelCacheFileName(const std::vector<std::string>& fileNames) const
+{
+  const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  if(cacheDir.isEmpty() || fileNames.empty() || !QDir().mkpath(cacheDir + "/SimRobotCore3"))
+    return std::string();
+
+  // 64 bit FNV-1a
+  std::uint64_t hash = 14695981039346656037ull;
+  const auto add = [&hash](const char* data, std::size_t size)
+  {
+    for(const char* end = data + size; data != end; ++data)
+      hash = (hash ^ static_cast<unsigned char>(*data)) * 1099511628211ull;
+  };
+  const auto addString = [&add](const std::string& string)
+  {
+    add(string.c_str(), string.size() + 1);
+  };
+
+  const auto addFile = [&add, &addString](const QFileInfo& file)
+  {
+    const qint64 size = file.size();
+    const qint64 lastModified = file.lastModified().toMSecsSinceEpoch();
+    addString(file.absoluteFilePath().toStdString());
+    add(reinterpret_cast<const char*>(&size), sizeof(size));
+    add(reinterpret_cast<const char*>(&lastModified), sizeof(lastModified));
+  };
+
+  const std::string version = std::string(mj_versionString()) + "/" + std::to_string(sizeof(mjtNum));
+  addString(version);
+
+  // The spec is built by the code of this module, so models compiled by another build of it must not be reused.
+  const QFileInfo module(QString::fromStdString(System::getModuleFileName(&Simulation::simulation)));
+  if(!module.exists())
+    return std::string();
+  addFile(module);
+
+  // Files are identified by their size and modification time, which avoids reading large meshes on every start.
+  for(const std::string& fileName : fileNames)
+  {
+    const QFileInfo file(QString::fromStdString(fileName));
+    if(!file.exists())
+      return std::string();
+    addFile(file);
+  }
+  for(const RegisteredName& name : names)
+  {
+    add(reinterpret_cast<const char*>(&name.type), sizeof(name.type));
+    addString(name.name);
+  }
+
+  // All cache files of a scene share the prefix, so outdated ones can be found.
+  const std::uint64_t sceneHash = std::hash<std::string>()(QFileInfo(QString::fromStdString(fileNames.front())).absoluteFilePath().toStdString());
+  return (cacheDir + QString("/SimRobotCore3/%1-%2.mjb").arg(sceneHash, 16, 16, QChar('0')).arg(hash, 16, 16, QChar('0'))).toStdString();
+}
+
+bool Simulation::loadCachedModel(const std::string& cacheFileName)
+{
+  if(!QFileInfo::exists(QString::fromStdString(cacheFileName)))
+    return false;
+  model = mj_loadModel(cacheFileName.c_str(), nullptr);
+  if(model && resolveNames())
+    return true;
+  if(model)
+  {
+    mj_deleteModel(model);
+    model = nullptr;
+  }
+  QFile::remove(QString::fromStdString(cacheFileName));
+  return false;
+}
+
+void Simulation::saveCachedModel(const std::string& cacheFileName) const
+{
+  const QFileInfo fileInfo(QString::fromStdString(cacheFileName));
+  const QString prefix = fileInfo.fileName().section('-', 0, 0);
+  QDir dir = fileInfo.dir();
+  for(const QString& outdated : dir.entryList({prefix + "-*.mjb"}, QDir::Files))
+    dir.remove(outdated);
+
+  // Write to a temporary file first, so that concurrently started simulators never see an incomplete model.
+  const std::string tempFileName = cacheFileName + "." + std::to_string(QCoreApplication::applicationPid());
+  mj_saveModel(model, tempFileName.c_str(), nullptr, 0);
+  if(!QFile::rename(QString::fromStdString(tempFileName), QString::fromStdString(cacheFileName)))
+    QFile::remove(QString::fromStdString(tempFileName));
+}
+
+bool Simulation::resolveNames()
+{
+  bodyMap.assign(model->nbody, nullptr);
+  geometryMap.assign(model->ngeom, nullptr);
+  for(auto& name : names)
+  {
+    const int id = mj_name2id(model, name.type, name.name.c_str());
+    if(id < 0)
+      return false;
+    if(name.type == mjOBJ_BODY)
+      bodyMap[id] = static_cast<Body*>(name.object);
+    else if(name.type == mjOBJ_GEOM)
+      geometryMap[id] = static_cast<Geometry*>(name.object);
+    if(name.indexPointer)
+      *(name.indexPointer) = id;
+  }
+  return true;
+}
+
 void Simulation::mjError(const char* message)
 {
   fprintf(stderr, "MuJoCo error: %s\n", message);
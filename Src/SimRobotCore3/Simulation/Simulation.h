@@ -8,17 +8,21 @@
 
 #include "Graphics/GraphicsContext.h"
 #include "Simulation/Appearances/ComplexAppearance.h"
+#include "Tools/QtTrajectoryLogCodec.h"
+#include "Tools/StepTimer.h"
 #include <mujoco/mjdata.h>
 #include <mujoco/mjmodel.h>
 #include <mujoco/mjspec.h>
 #include <string>
 #include <list>
 #include <unordered_map>
+#include <vector>
 
 class Body;
 class Geometry;
 class Scene;
 class ElementCore3;
+class MeshGeometry;
 
 /**
  * @class Simulation
@@ -57,8 +61,14 @@ public:
   Pose3f dragPlanePose; /**< Pose of the drag plane (assuming it is not possible to drag simultaneously in multiple renderers). */
   std::vector<GraphicsContext::Surface*> bodySurfaces; /**< The special surfaces for each body, used by \c ObjectSegmentedImageSensor. */
   std::unordered_map<ComplexAppearance::Descriptor, GraphicsContext::Mesh*, ComplexAppearance::Hasher> complexAppearanceMeshCache; /**< The cache for meshes generated by complex appearances. */
+  std::unordered_map<std::string, GraphicsContext::Mesh*> meshAppearanceMeshCache; /**< The cache for meshes loaded by mesh appearances (keyed by file, unit and whether texture coordinates are used). */
+  std::vector<MeshGeometry*> meshGeometries; /**< The mesh geometries, whose drawings can only be created after the model has been compiled. */
 
   unsigned int currentFrameRate = 0; /**< The current frame rate of the simulation */
+  float renderInterpolation = 1.f; /**< Where renderers draw between the previous (0) and the current step (1) */
+  std::vector<mjtNum> previousXpos; /**< The body positions before the most recent step (only kept if the scene runs in real time) */
+  std::vector<mjtNum> previousXquat; /**< The body orientations before the most recent step (only kept if the scene runs in real time) */
+  unsigned int loadTime = 0; /**< The time in ms it took to load the scene */
 
   /** Default Constructor. */
   Simulation();
@@ -83,14 +93,56 @@ public:
    */
   const char* getName(int type, const char* prefix, int* indexPointer = nullptr, void* object = nullptr)
   {
-    static int counter = 0;
-    const std::string name = std::string(prefix) + "_" + std::to_string(counter++);
+    const std::string name = std::string(prefix) + "_" + std::to_string(nameCounter++);
     names.emplace_back(type, name, indexPointer, object);
     return names.back().name.c_str();
   }
 
   /** Executes one simulation step */
   void doSimulationStep();
+
+  /**
+   * Determines how many steps are due to keep the simulated time in sync with the real time
+   * (scaled by \c Scene::realTimeFactor) and updates \c renderInterpolation accordingly.
+   * At most \c Scene::maxSubSteps steps are due, so a larger backlog is dropped. Without real time or if the
+   * simulation is stepped manually, exactly one step is due and the real time starts over when it runs again
+   * @return The number of steps to execute now
+   */
+  unsigned int getDueSteps();
+
+  /**
+   * Starts writing the state of each simulation step to a log, beginning with the next step
+   * @param fileName The name of the log file
+   * @return Whether the file could be created
+   */
+  bool startRecording(const std::string& fileName);
+
+  /** Stops writing the log and completes the file */
+  void stopRecording();
+
+  /**
+   * Starts replaying a log instead of simulating, beginning with its first state
+   * @param fileName The name of the log file
+   * @return Whether the file is a log of a scene with the same state layout
+   */
+  bool startReplay(const std::string& fileName);
+
+  /** Stops replaying, i.e. the simulation continues from the state replayed last */
+  void stopReplay();
+
+  /**
+   * Jumps to a state in the replayed log
+   * @param frame The index of the state in the log
+   * @return Whether the state could be read
+   */
+  bool seekReplay(unsigned int frame);
+
+  /** Advances the replay by one state (instead of \c doSimulationStep) */
+  void doReplayStep();
+
+  TrajectoryLogWriter recorder{qtTrajectoryLogCodec}; /**< Writes the states to a log while recording */
+  TrajectoryLogReader replayer{qtTrajectoryLogCodec}; /**< Reads the states from a log while replaying */
+  unsigned int replayFrame = 0; /**< The index of the next state to replay */
   unsigned int simulationStep = 0;
   double simulatedTime = 0;
   unsigned int collisions = 0;
@@ -100,10 +152,70 @@ public:
   void registerObjects();
 
 private:
+  /**
+   * Returns the number of values in a state as it is logged, i.e. the step, the time, the generalized
+   * positions and velocities, the actuator activations, the mocap poses and the MuJoCo sensor readings.
+   * @return The number of values
+   */
+  std::size_t getStateSize() const;
+
+  /** Copies the state from which the poses of the current step are computed into \c state (before it is integrated) */
+  void recordState();
+
+  /** Adds the sensor readings of the current step to \c state and appends it to the log that is recorded */
+  void writeState();
+
+  /**
+   * Sets the part of a logged state that determines the poses and computes the poses of all bodies from it
+   * @param value The logged state after the step and the time
+   * @param target The MuJoCo data that is set
+   * @return The logged sensor readings, which follow that part
+   */
+  const mjtNum* applyState(const mjtNum* value, mjData& target) const;
+
+  /**
+   * Reads a state from the replayed log and computes the poses of all bodies from it
+   * @param frame The index of the state in the log
+   * @return Whether the state could be read
+   */
+  bool replayState(unsigned int frame);
+
+  std::vector<mjtNum> state; /**< Buffer for a logged state */
+  mjData* recordCheckData = nullptr; /**< MuJoCo data used to check that the recorded states are replayed correctly (only in debug builds) */
+
   /** Computes the frame rate of simulation */
   void updateFrameRate();
   unsigned int lastFrameRateComputationTime = 0;
   unsigned int lastFrameRateComputationStep = 0;
+  StepTimer stepTimer; /**< Determines the number of steps that are due in real time */
+
+  /**
+   * Determines the name of the file in which the compiled model of the current scene is cached.
+   * The name contains a hash of the scene files, the registered names and the MuJoCo version,
+   * so a changed scene never uses a stale model.
+   * @param fileNames The names of all scene files that were parsed
+   * @return The file name or an empty string if there is no writable cache directory
+   */
+  std::string getModelCacheFileName(const std::vector<std::string>& fileNames) const;
+
+  /**
+   * Loads the compiled model from the cache.
+   * @param cacheFileName The name of the cache file
+   * @return Whether a model was loaded and all registered names were found in it
+   */
+  bool loadCachedModel(const std::string& cacheFileName);
+
+  /**
+   * Stores the compiled model in the cache and removes outdated cache files of the same scene.
+   * @param cacheFileName The name of the cache file
+   */
+  void saveCachedModel(const std::string& cacheFileName) const;
+
+  /**
+   * Maps the registered names to the indices MuJoCo assigned to them.
+   * @return Whether all registered names were found in the model
+   */
+  bool resolveNames();
 
   static void mjError(const char*);
   static void mjWarning(const char*);
@@ -116,4 +228,5 @@ private:
     void* object = nullptr; /**< Pointer to the (SimRobot) object (used to map from the MuJoCo index to the object). */
   };
   std::list<RegisteredName> names; /**< The registered names of MuJoCo objects. */
+  int nameCounter = 0; /**< The number of names created by \c getName (makes the names unique and reproducible) */
 };